@@ -0,0 +1,237 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <mp/seqlock_inplace_string.h>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+namespace mp {
+
+  namespace detail {
+    constexpr std::memory_order cas_failure_order(std::memory_order order)
+    {
+      return order == std::memory_order_acq_rel ? std::memory_order_acquire
+                                                : order == std::memory_order_release ? std::memory_order_relaxed : order;
+    }
+
+    // one 64-bit word operated with std::atomic
+    struct atomic_word64 {
+      using word_type = std::uint64_t;
+      static constexpr bool is_always_lock_free = std::atomic<word_type>::is_always_lock_free;
+
+      std::atomic<word_type> word;
+
+      word_type load(std::memory_order order) const noexcept { return word.load(order); }
+      void store(word_type desired, std::memory_order order) noexcept { word.store(desired, order); }
+      word_type exchange(word_type desired, std::memory_order order) noexcept { return word.exchange(desired, order); }
+      bool compare_exchange(word_type& expected, word_type desired, std::memory_order order) noexcept
+      {
+        return word.compare_exchange_strong(expected, desired, order, cas_failure_order(order));
+      }
+    };
+
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)
+    __extension__ typedef unsigned __int128 uint128_t;
+
+    // one 128-bit word operated with a double-width CAS (e.g. cmpxchg16b enabled with -mcx16 on x86-64);
+    // the __sync builtins are full barriers so the requested memory order is always satisfied. There is no
+    // plain 128-bit atomic load, so load() is a CAS too and takes the cache line exclusively.
+    struct atomic_word128 {
+      using word_type = uint128_t;
+      static constexpr bool is_always_lock_free = true;
+
+      alignas(16) mutable word_type word;
+
+      word_type load(std::memory_order) const noexcept { return __sync_val_compare_and_swap(&word, 0, 0); }
+      void store(word_type desired, std::memory_order order) noexcept { exchange(desired, order); }
+      word_type exchange(word_type desired, std::memory_order order) noexcept
+      {
+        word_type expected = load(order);
+        while(!compare_exchange(expected, desired, order)) {
+        }
+        return expected;
+      }
+      bool compare_exchange(word_type& expected, word_type desired, std::memory_order) noexcept
+      {
+        const word_type previous = __sync_val_compare_and_swap(&word, expected, desired);
+        const bool success = previous == expected;
+        expected = previous;
+        return success;
+      }
+    };
+#endif
+  }
+
+  // std::atomic-like wrapper for basic_inplace_string.
+  //
+  // Strings that fit in 8 bytes (or 16 bytes on targets with a double-width CAS) are operated with
+  // single lock-free atomic instructions. Unused characters are zeroed before publishing so that
+  // equal strings have equal object representations, which compare_exchange relies on. Bigger
+  // strings fall back to a seqlock with writers serialized by a spin lock; readers stay lock-free.
+  //
+  // On x86-64 the 16-byte path needs -mcx16 (added by the mp::inplace_string CMake target), otherwise
+  // atomic_inplace_string<15> silently uses the seqlock. Its load() is a compare-and-swap that writes
+  // the cache line, so unlike the 8-byte and seqlock paths concurrent readers contend with each other
+  // and with writers; prefer seqlock_inplace_string for read-mostly values.
+  template<typename CharT, std::size_t MaxSize, typename Traits = std::char_traits<std::decay_t<CharT>>>
+  class basic_atomic_inplace_string {
+  public:
+    using value_type = basic_inplace_string<CharT, MaxSize, Traits>;
+    static_assert(std::is_trivially_copyable_v<value_type>, "value_type must be trivially copyable");
+
+  private:
+    struct seqlock_storage {
+      static constexpr bool is_always_lock_free = false;
+      basic_seqlock_inplace_string<CharT, MaxSize, Traits> value;
+      std::atomic_flag writer = ATOMIC_FLAG_INIT;
+
+      void lock() noexcept
+      {
+        while(writer.test_and_set(std::memory_order_acquire)) {
+        }
+      }
+      void unlock() noexcept { writer.clear(std::memory_order_release); }
+    };
+    using storage_type = std::conditional_t<sizeof(value_type) <= sizeof(std::uint64_t), detail::atomic_word64,
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)
+                                            std::conditional_t<sizeof(value_type) <= sizeof(detail::uint128_t),
+                                                               detail::atomic_word128, seqlock_storage>
+#else
+                                            seqlock_storage
+#endif
+                                            >;
+    static constexpr bool is_word = !std::is_same_v<storage_type, seqlock_storage>;
+
+  public:
+    static constexpr bool is_always_lock_free = storage_type::is_always_lock_free;
+
+    basic_atomic_inplace_string() noexcept : basic_atomic_inplace_string{value_type{}} {}
+    basic_atomic_inplace_string(const value_type& value) noexcept
+    {
+      if constexpr(is_word)
+        storage_.word = to_word(value);
+      else
+        storage_.value.store(value);
+    }
+    basic_atomic_inplace_string(const basic_atomic_inplace_string&) = delete;
+    basic_atomic_inplace_string& operator=(const basic_atomic_inplace_string&) = delete;
+
+    bool is_lock_free() const noexcept { return is_always_lock_free; }
+
+    value_type load(std::memory_order order = std::memory_order_seq_cst) const noexcept
+    {
+      if constexpr(is_word)
+        return from_word(storage_.load(order));
+      else
+        return storage_.value.load();
+    }
+    operator value_type() const noexcept { return load(); }
+
+    void store(const value_type& desired, std::memory_order order = std::memory_order_seq_cst) noexcept
+    {
+      if constexpr(is_word)
+        storage_.store(to_word(desired), order);
+      else {
+        storage_.lock();
+        storage_.value.store(desired);
+        storage_.unlock();
+      }
+    }
+    value_type operator=(const value_type& desired) noexcept
+    {
+      store(desired);
+      return desired;
+    }
+
+    value_type exchange(const value_type& desired, std::memory_order order = std::memory_order_seq_cst) noexcept
+    {
+      if constexpr(is_word)
+        return from_word(storage_.exchange(to_word(desired), order));
+      else {
+        storage_.lock();
+        const auto previous = storage_.value.load();
+        storage_.value.store(desired);
+        storage_.unlock();
+        return previous;
+      }
+    }
+
+    // compares the text (not the unused bytes) of the current value and 'expected'
+    bool compare_exchange_strong(value_type& expected, const value_type& desired,
+                                 std::memory_order order = std::memory_order_seq_cst) noexcept
+    {
+      if constexpr(is_word) {
+        auto expected_word = to_word(expected);
+        const bool success = storage_.compare_exchange(expected_word, to_word(desired), order);
+        if(!success) expected = from_word(expected_word);
+        return success;
+      }
+      else {
+        storage_.lock();
+        const auto current = storage_.value.load();
+        const bool success = current == expected;
+        if(success)
+          storage_.value.store(desired);
+        else
+          expected = current;
+        storage_.unlock();
+        return success;
+      }
+    }
+    bool compare_exchange_weak(value_type& expected, const value_type& desired,
+                               std::memory_order order = std::memory_order_seq_cst) noexcept
+    {
+      return compare_exchange_strong(expected, desired, order);
+    }
+
+  private:
+    storage_type storage_;
+
+    template<typename Storage = storage_type, typename Word = typename Storage::word_type>
+    static Word to_word(const value_type& value) noexcept
+    {
+      Word word{};
+      std::memcpy(&word, &value, sizeof(value));
+      const auto size = value.size();
+      if(size < MaxSize)
+        std::memset(reinterpret_cast<unsigned char*>(&word) + (size + 1) * sizeof(CharT), 0,
+                    (MaxSize - size - 1) * sizeof(CharT));
+      return word;
+    }
+    template<typename Word>
+    static value_type from_word(const Word& word) noexcept
+    {
+      value_type value;
+      std::memcpy(static_cast<void*>(&value), &word, sizeof(value));
+      return value;
+    }
+  };
+
+  // aliases
+  template<std::size_t MaxSize>
+  using atomic_inplace_string = basic_atomic_inplace_string<char, MaxSize>;
+  template<std::size_t MaxSize>
+  using atomic_inplace_wstring = basic_atomic_inplace_string<wchar_t, MaxSize>;
+}
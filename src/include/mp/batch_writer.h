@@ -0,0 +1,189 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#if __has_include(<sys/uio.h>)
+#include <climits>
+#include <sys/uio.h>
+#include <unistd.h>
+#define MP_BATCH_WRITER_HAS_WRITEV 1
+#endif
+
+// Batched output of many short strings (e.g. basic_inplace_string fields of exported records).
+// Every value is taken as a std::string_view so its length is known without rescanning.
+
+namespace mp {
+
+#if defined(MP_BATCH_WRITER_HAS_WRITEV)
+
+  // Collects the values as iovec entries and writes a whole batch with one writev() call.
+  //
+  // Only pointers to the characters are stored, so the values must stay alive and unchanged
+  // until the next flush() (or the automatic flush of a full batch). Temporaries are therefore
+  // rejected at compile time; use buffered_batch_writer to write values that do not outlive the
+  // call. A batch is flushed automatically when BatchSize entries are collected and on destruction
+  // (where errors are ignored).
+  template<std::size_t BatchSize = 64>
+  class iovec_batch_writer {
+#if defined(IOV_MAX)
+    static_assert(BatchSize > 0 && BatchSize <= IOV_MAX, "writev() accepts at most IOV_MAX buffers");
+#else
+    static_assert(BatchSize > 0 && BatchSize <= 1024, "writev() accepts at most IOV_MAX buffers");
+#endif
+
+  public:
+    explicit iovec_batch_writer(int fd) noexcept : fd_{fd} {}
+    iovec_batch_writer(const iovec_batch_writer&) = delete;
+    iovec_batch_writer& operator=(const iovec_batch_writer&) = delete;
+    ~iovec_batch_writer()
+    {
+      try {
+        flush();
+      }
+      catch(...) {
+      }
+    }
+
+    template<typename... Strings>
+    void add(const Strings&... values)
+    {
+      (append(std::string_view{values}), ...);
+    }
+    // the storage of a temporary is gone before writev() runs
+    template<typename... Strings, std::enable_if_t<(... || !std::is_lvalue_reference_v<Strings>), bool> = true>
+    void add(Strings&&... values) = delete;
+
+    std::size_t pending() const noexcept { return count_; }
+
+    void flush()
+    {
+      std::size_t first = 0;
+      while(first != count_) {
+        const ssize_t written = ::writev(fd_, iov_.data() + first, static_cast<int>(count_ - first));
+        if(written < 0) {
+          if(errno == EINTR) continue;
+          const int error = errno;
+          count_ = 0;
+          throw std::system_error(error, std::generic_category(), "mp::iovec_batch_writer: writev() failed");
+        }
+        // skip the fully written entries and continue a partially written one
+        auto left = static_cast<std::size_t>(written);
+        while(first != count_ && left >= iov_[first].iov_len) left -= iov_[first++].iov_len;
+        if(left > 0) {
+          iov_[first].iov_base = static_cast<char*>(iov_[first].iov_base) + left;
+          iov_[first].iov_len -= left;
+        }
+      }
+      count_ = 0;
+    }
+
+  private:
+    int fd_;
+    std::size_t count_ = 0;
+    std::array<iovec, BatchSize> iov_;
+
+    void append(std::string_view sv)
+    {
+      if(sv.empty()) return;
+      if(count_ == BatchSize) flush();
+      iov_[count_++] = {const_cast<char*>(sv.data()), sv.size()};
+    }
+  };
+
+#endif
+
+  // Copies the values into a caller-supplied buffer and writes its content with a single fwrite()
+  // whenever the next value does not fit. Values longer than the whole buffer are written directly.
+  // The buffer is flushed on destruction (where errors are ignored).
+  class buffered_batch_writer {
+  public:
+    buffered_batch_writer(std::FILE* file, char* buffer, std::size_t size) noexcept
+        : file_{file}, buffer_{buffer}, size_{size}
+    {
+    }
+    template<std::size_t N>
+    buffered_batch_writer(std::FILE* file, char (&buffer)[N]) noexcept : buffered_batch_writer{file, buffer, N}
+    {
+    }
+    buffered_batch_writer(const buffered_batch_writer&) = delete;
+    buffered_batch_writer& operator=(const buffered_batch_writer&) = delete;
+    ~buffered_batch_writer()
+    {
+      try {
+        flush();
+      }
+      catch(...) {
+      }
+    }
+
+    template<typename... Strings>
+    void add(const Strings&... values)
+    {
+      (append(std::string_view{values}), ...);
+    }
+
+    std::size_t pending() const noexcept { return used_; }
+
+    void flush()
+    {
+      const auto used = used_;
+      used_ = 0;
+      write(buffer_, used);
+    }
+
+  private:
+    std::FILE* file_;
+    char* buffer_;
+    std::size_t size_;
+    std::size_t used_ = 0;
+
+    void append(std::string_view sv)
+    {
+      if(sv.size() > size_ - used_) {
+        flush();
+        if(sv.size() > size_) {
+          write(sv.data(), sv.size());
+          return;
+        }
+      }
+      std::memcpy(buffer_ + used_, sv.data(), sv.size());
+      used_ += sv.size();
+    }
+
+    void write(const char* data, std::size_t size)
+    {
+      if(size > 0 && std::fwrite(data, 1, size, file_) != size)
+        throw std::system_error(errno, std::generic_category(), "mp::buffered_batch_writer: fwrite() failed");
+    }
+  };
+
+}
@@ -0,0 +1,400 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <mp/inplace_string.h>
+#include <cstring>
+#include <functional>
+#include <memory_resource>
+#include <new>
+#include <ostream>
+
+namespace mp {
+
+  // Memory resource policy of basic_hybrid_string: the resource current at the time of a spill.
+  struct default_memory_resource {
+    static std::pmr::memory_resource* get() noexcept { return std::pmr::get_default_resource(); }
+  };
+
+  // A sibling of basic_inplace_string with the same in-place layout that, instead of throwing
+  // std::length_error, spills the text to a std::pmr::memory_resource when it does not fit.
+  //
+  // The spilled state is flagged with a value of the trailing size byte that is invalid for
+  // basic_inplace_string (the maximum of impl_size_type). In that state the first bytes of the
+  // in-place storage hold a pointer to a heap block with the resource that allocated it, the size and
+  // the capacity, followed by the characters. The storage is padded to fit that pointer, so capacities
+  // below sizeof(void*) code units make the object larger than the matching basic_inplace_string.
+  // Spilled buffers are allocated from MemoryResource::get() at the time of the spill.
+  template<typename CharT, std::size_t MaxSize, typename Traits = std::char_traits<std::decay_t<CharT>>,
+           typename MemoryResource = default_memory_resource>
+  class basic_hybrid_string {
+    using impl_size_type = ::mp::detail::impl_size_type_helper<sizeof(CharT)>;
+    static constexpr impl_size_type spilled_tag = std::numeric_limits<impl_size_type>::max();
+    static_assert(MaxSize < spilled_tag, "impl_size_type type too small to store MaxSize characters and spill tag");
+
+    struct heap_rep {
+      std::pmr::memory_resource* resource;
+      std::uint32_t size;
+      std::uint32_t capacity;
+      // followed by capacity + 1 characters
+    };
+    static constexpr std::size_t pointer_units = (sizeof(heap_rep*) + sizeof(CharT) - 1) / sizeof(CharT);
+    static constexpr std::size_t storage_size = MaxSize < pointer_units ? pointer_units : MaxSize;
+
+  public:
+    using traits_type = Traits;
+    using value_type = CharT;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = value_type*;
+    using const_pointer = const value_type*;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using iterator = value_type*;
+    using const_iterator = const value_type*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+    // constructors
+    basic_hybrid_string() noexcept { set_inline_size(0); }
+    basic_hybrid_string(const basic_hybrid_string& other) : basic_hybrid_string{}
+    {
+      if(other.is_inline())
+        chars_ = other.chars_;
+      else
+        assign(other.data(), other.size());
+    }
+    basic_hybrid_string(basic_hybrid_string&& other) noexcept : chars_{other.chars_} { other.set_inline_size(0); }
+    explicit basic_hybrid_string(std::basic_string_view<CharT, Traits> sv) : basic_hybrid_string{sv.data(), sv.size()}
+    {
+    }
+    template<std::size_t OtherMaxSize>
+    basic_hybrid_string(const basic_inplace_string<CharT, OtherMaxSize, Traits>& str)
+        : basic_hybrid_string{str.data(), str.size()}
+    {
+    }
+    basic_hybrid_string(const_pointer s, size_type count) : basic_hybrid_string{} { assign(s, count); }
+    basic_hybrid_string(const_pointer s) : basic_hybrid_string{s, traits_type::length(s)} {}
+    basic_hybrid_string(size_type n, value_type c) : basic_hybrid_string{} { assign(n, c); }
+    basic_hybrid_string(std::initializer_list<CharT> ilist) : basic_hybrid_string{ilist.begin(), ilist.size()} {}
+    ~basic_hybrid_string() { release(); }
+
+    // assignment
+    basic_hybrid_string& operator=(const basic_hybrid_string& other)
+    {
+      if(this != &other) {
+        if(is_inline() && other.is_inline())
+          chars_ = other.chars_;
+        else
+          assign(other.data(), other.size());
+      }
+      return *this;
+    }
+    basic_hybrid_string& operator=(basic_hybrid_string&& other) noexcept
+    {
+      if(this != &other) {
+        release();
+        chars_ = other.chars_;
+        other.set_inline_size(0);
+      }
+      return *this;
+    }
+    basic_hybrid_string& operator=(std::basic_string_view<CharT, Traits> sv) { return assign(sv); }
+    basic_hybrid_string& operator=(const_pointer s) { return assign(s); }
+    basic_hybrid_string& operator=(value_type c) { return assign(1, c); }
+    basic_hybrid_string& operator=(std::initializer_list<CharT> ilist) { return assign(ilist.begin(), ilist.size()); }
+
+    // iterators
+    iterator begin() { return data(); }
+    const_iterator begin() const { return data(); }
+    iterator end() { return begin() + size(); }
+    const_iterator end() const { return begin() + size(); }
+    reverse_iterator rbegin() { return reverse_iterator{end()}; }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator{end()}; }
+    reverse_iterator rend() { return reverse_iterator{begin()}; }
+    const_reverse_iterator rend() const { return const_reverse_iterator{begin()}; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    const_reverse_iterator crbegin() const { return rbegin(); }
+    const_reverse_iterator crend() const { return rend(); }
+
+    // capacity
+    size_type size() const { return is_inline() ? MaxSize - static_cast<impl_size_type>(chars_.back()) : heap()->size; }
+    size_type length() const { return size(); }
+    size_type max_size() const { return std::numeric_limits<std::uint32_t>::max(); }
+    size_type capacity() const { return is_inline() ? MaxSize : heap()->capacity; }
+    bool is_inline() const { return static_cast<impl_size_type>(chars_.back()) != spilled_tag; }
+    void reserve(size_type n)
+    {
+      if(n <= capacity()) return;
+      if(n > max_size()) throw std::length_error("mp::basic_hybrid_string: size() > max_size()");
+
+      const auto sz = size();
+      auto* resource = is_inline() ? MemoryResource::get() : heap()->resource;
+      auto* rep = ::new(resource->allocate(allocation_size(n), alignof(heap_rep)))
+          heap_rep{resource, static_cast<std::uint32_t>(sz), static_cast<std::uint32_t>(n)};
+      traits_type::copy(heap_data(rep), data(), sz + 1);
+      release();
+      set_heap(rep);
+    }
+    // returns to the in-place storage if the text fits there
+    void shrink_to_fit()
+    {
+      if(is_inline() || size() > MaxSize) return;
+      auto* const rep = heap();
+      traits_type::copy(chars_.data(), heap_data(rep), rep->size);
+      set_inline_size(rep->size);
+      deallocate(rep);
+    }
+    void resize(size_type n, value_type c)
+    {
+      const auto sz = size();
+      size(n);
+      if(n > sz) traits_type::assign(data() + sz, n - sz, c);
+    }
+    void resize(size_type n) { resize(n, value_type{}); }
+    void clear() { size(0); }
+    bool empty() const { return size() == 0; }
+
+    // element access
+    const_reference operator[](size_type pos) const { return data()[pos]; }
+    reference operator[](size_type pos) { return data()[pos]; }
+    const_reference at(size_type pos) const
+    {
+      if(pos >= size()) throw std::out_of_range("hybrid_string::at: 'pos' out of range");
+      return (*this)[pos];
+    }
+    reference at(size_type pos)
+    {
+      if(pos >= size()) throw std::out_of_range("hybrid_string::at: 'pos' out of range");
+      return (*this)[pos];
+    }
+    reference front() { return (*this)[0]; }
+    const_reference front() const { return (*this)[0]; }
+    reference back() { return (*this)[size() - 1]; }
+    const_reference back() const { return (*this)[size() - 1]; }
+
+    // modifiers
+    basic_hybrid_string& operator+=(std::basic_string_view<CharT, Traits> sv) { return append(sv); }
+    basic_hybrid_string& operator+=(const_pointer s) { return append(s); }
+    basic_hybrid_string& operator+=(value_type c)
+    {
+      push_back(c);
+      return *this;
+    }
+    basic_hybrid_string& operator+=(std::initializer_list<CharT> il) { return append(il.begin(), il.size()); }
+
+    basic_hybrid_string& append(std::basic_string_view<CharT, Traits> sv) { return append(sv.data(), sv.size()); }
+    basic_hybrid_string& append(const_pointer s, size_type n)
+    {
+      const auto sz = size();
+      if(sz + n > capacity()) {
+        // 's' may point into our own buffer
+        const bool self = std::less_equal<const_pointer>{}(data(), s) && std::less<const_pointer>{}(s, data() + sz);
+        const auto offset = self ? static_cast<size_type>(s - data()) : 0;
+        grow(sz + n);
+        if(self) s = data() + offset;
+      }
+      traits_type::move(data() + sz, s, n);
+      size(sz + n);
+      return *this;
+    }
+    basic_hybrid_string& append(const_pointer s) { return append(s, traits_type::length(s)); }
+    basic_hybrid_string& append(size_type n, value_type c)
+    {
+      resize(size() + n, c);
+      return *this;
+    }
+    void push_back(value_type c)
+    {
+      const auto sz = size();
+      if(sz == capacity()) grow(sz + 1);
+      traits_type::assign(data()[sz], c);
+      size(sz + 1);
+    }
+    void pop_back() { size(size() - 1); }
+
+    basic_hybrid_string& assign(std::basic_string_view<CharT, Traits> sv) { return assign(sv.data(), sv.size()); }
+    basic_hybrid_string& assign(const_pointer s, size_type count)
+    {
+      if(count > capacity()) {
+        basic_hybrid_string tmp;
+        tmp.reserve(count);
+        tmp.assign(s, count);
+        swap(tmp);
+        return *this;
+      }
+      traits_type::move(data(), s, count);
+      size(count);
+      return *this;
+    }
+    basic_hybrid_string& assign(const_pointer s) { return assign(s, traits_type::length(s)); }
+    basic_hybrid_string& assign(size_type count, CharT ch)
+    {
+      reserve(count);
+      traits_type::assign(data(), count, ch);
+      size(count);
+      return *this;
+    }
+
+    // string operations
+    const_pointer c_str() const { return data(); }
+    pointer data() { return is_inline() ? chars_.data() : heap_data(heap()); }
+    const_pointer data() const { return is_inline() ? chars_.data() : heap_data(heap()); }
+    operator std::basic_string_view<CharT, Traits>() const noexcept { return {data(), size()}; }
+
+    // modifiers
+    void swap(basic_hybrid_string& other) noexcept { std::swap(chars_, other.chars_); }
+
+  private:
+    std::array<value_type, storage_size + 1> chars_;  // in-place: as in basic_inplace_string, spilled: heap_rep* + tag
+
+    static std::size_t allocation_size(size_type capacity) { return sizeof(heap_rep) + (capacity + 1) * sizeof(CharT); }
+    static CharT* heap_data(heap_rep* rep) { return reinterpret_cast<CharT*>(rep + 1); }
+    heap_rep* heap() const
+    {
+      heap_rep* rep;
+      std::memcpy(&rep, chars_.data(), sizeof(rep));
+      return rep;
+    }
+    void set_heap(heap_rep* rep)
+    {
+      std::memcpy(chars_.data(), &rep, sizeof(rep));
+      chars_.back() = static_cast<value_type>(spilled_tag);
+    }
+    static void deallocate(heap_rep* rep) noexcept
+    {
+      rep->resource->deallocate(rep, allocation_size(rep->capacity), alignof(heap_rep));
+    }
+    void set_inline_size(size_type s)
+    {
+      chars_[s] = '\0';
+      chars_.back() = static_cast<impl_size_type>(MaxSize - s);
+    }
+    void release() noexcept
+    {
+      if(is_inline()) return;
+      deallocate(heap());
+      set_inline_size(0);
+    }
+    void grow(size_type n)
+    {
+      const auto cap = capacity();
+      reserve(n > max_size() / 2 || n > 2 * cap ? n : 2 * cap);
+    }
+    void size(size_type s)
+    {
+      if(s > capacity()) grow(s);
+      if(s <= MaxSize && is_inline())
+        set_inline_size(s);
+      else {
+        auto* const rep = heap();
+        rep->size = static_cast<std::uint32_t>(s);
+        heap_data(rep)[s] = '\0';
+      }
+    }
+  };
+
+  // relational operators
+  template<typename CharT, std::size_t MaxSize, class Traits, class MemoryResource>
+  bool operator==(const basic_hybrid_string<CharT, MaxSize, Traits, MemoryResource>& lhs,
+                  const basic_hybrid_string<CharT, MaxSize, Traits, MemoryResource>& rhs)
+  {
+    return std::basic_string_view<CharT, Traits>{lhs} == std::basic_string_view<CharT, Traits>{rhs};
+  }
+
+  template<typename CharT, std::size_t MaxSize, class Traits, class MemoryResource>
+  bool operator!=(const basic_hybrid_string<CharT, MaxSize, Traits, MemoryResource>& lhs,
+                  const basic_hybrid_string<CharT, MaxSize, Traits, MemoryResource>& rhs)
+  {
+    return !(lhs == rhs);
+  }
+
+  template<typename CharT, std::size_t MaxSize, class Traits, class MemoryResource>
+  bool operator<(const basic_hybrid_string<CharT, MaxSize, Traits, MemoryResource>& lhs,
+                 const basic_hybrid_string<CharT, MaxSize, Traits, MemoryResource>& rhs)
+  {
+    return std::basic_string_view<CharT, Traits>{lhs} < std::basic_string_view<CharT, Traits>{rhs};
+  }
+
+  template<typename CharT, std::size_t MaxSize, class Traits, class MemoryResource>
+  bool operator<=(const basic_hybrid_string<CharT, MaxSize, Traits, MemoryResource>& lhs,
+                  const basic_hybrid_string<CharT, MaxSize, Traits, MemoryResource>& rhs)
+  {
+    return !(rhs < lhs);
+  }
+
+  template<typename CharT, std::size_t MaxSize, class Traits, class MemoryResource>
+  bool operator>(const basic_hybrid_string<CharT, MaxSize, Traits, MemoryResource>& lhs,
+                 const basic_hybrid_string<CharT, MaxSize, Traits, MemoryResource>& rhs)
+  {
+    return rhs < lhs;
+  }
+
+  template<typename CharT, std::size_t MaxSize, class Traits, class MemoryResource>
+  bool operator>=(const basic_hybrid_string<CharT, MaxSize, Traits, MemoryResource>& lhs,
+                  const basic_hybrid_string<CharT, MaxSize, Traits, MemoryResource>& rhs)
+  {
+    return !(lhs < rhs);
+  }
+
+  // comparison with c-style string
+  template<typename CharT, std::size_t MaxSize, class Traits, class MemoryResource>
+  bool operator==(const CharT* lhs, const basic_hybrid_string<CharT, MaxSize, Traits, MemoryResource>& rhs)
+  {
+    return std::basic_string_view<CharT, Traits>{lhs} == std::basic_string_view<CharT, Traits>{rhs};
+  }
+
+  template<typename CharT, std::size_t MaxSize, class Traits, class MemoryResource>
+  bool operator==(const basic_hybrid_string<CharT, MaxSize, Traits, MemoryResource>& lhs, const CharT* rhs)
+  {
+    return std::basic_string_view<CharT, Traits>{lhs} == std::basic_string_view<CharT, Traits>{rhs};
+  }
+
+  template<typename CharT, std::size_t MaxSize, class Traits, class MemoryResource>
+  bool operator!=(const CharT* lhs, const basic_hybrid_string<CharT, MaxSize, Traits, MemoryResource>& rhs)
+  {
+    return !(lhs == rhs);
+  }
+
+  template<typename CharT, std::size_t MaxSize, class Traits, class MemoryResource>
+  bool operator!=(const basic_hybrid_string<CharT, MaxSize, Traits, MemoryResource>& lhs, const CharT* rhs)
+  {
+    return !(lhs == rhs);
+  }
+
+  // input/output
+  template<typename CharT, std::size_t MaxSize, class Traits, class MemoryResource>
+  inline std::basic_ostream<CharT, Traits>& operator<<(
+      std::basic_ostream<CharT, Traits>& os, const basic_hybrid_string<CharT, MaxSize, Traits, MemoryResource>& v)
+  {
+    return os << std::basic_string_view<CharT, Traits>{v};
+  }
+
+  // aliases
+  template<std::size_t MaxSize, typename MemoryResource = default_memory_resource>
+  using hybrid_string = basic_hybrid_string<char, MaxSize, std::char_traits<char>, MemoryResource>;
+  template<std::size_t MaxSize, typename MemoryResource = default_memory_resource>
+  using hybrid_wstring = basic_hybrid_string<wchar_t, MaxSize, std::char_traits<wchar_t>, MemoryResource>;
+}
@@ -0,0 +1,344 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <mp/inplace_string.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+// Hex and base64 (RFC 4648, standard alphabet with '=' padding) conversions between byte sequences and
+// char inplace strings.
+//
+// Encoded and decoded capacities are derived from the source capacity at compile time. Hex uses SSE2
+// kernels (32 characters per step), base64 uses SSSE3 kernels when enabled (e.g. -mssse3 or -march=native)
+// and table-driven scalar code otherwise.
+
+namespace mp {
+
+  template<std::size_t N>
+  constexpr std::size_t hex_encoded_capacity = 2 * N;
+  template<std::size_t N>
+  constexpr std::size_t hex_decoded_capacity = N / 2;
+  template<std::size_t N>
+  constexpr std::size_t base64_encoded_capacity = 4 * ((N + 2) / 3);
+  template<std::size_t N>
+  constexpr std::size_t base64_decoded_capacity = N * 3 / 4;
+
+  namespace detail {
+
+    template<typename Byte>
+    constexpr bool is_byte = sizeof(Byte) == 1 && (std::is_integral_v<Byte> || std::is_same_v<Byte, std::byte>);
+
+    constexpr char hex_digits[] = "0123456789abcdef";
+    constexpr char base64_alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    constexpr std::uint8_t invalid_digit = 0xFF;
+
+    struct digit_table {
+      std::uint8_t values[256] = {};
+    };
+
+    constexpr digit_table make_hex_table()
+    {
+      digit_table t;
+      for(int c = 0; c < 256; ++c) t.values[c] = invalid_digit;
+      for(int i = 0; i < 10; ++i) t.values['0' + i] = static_cast<std::uint8_t>(i);
+      for(int i = 0; i < 6; ++i) t.values['a' + i] = t.values['A' + i] = static_cast<std::uint8_t>(10 + i);
+      return t;
+    }
+    constexpr digit_table make_base64_table()
+    {
+      digit_table t;
+      for(int c = 0; c < 256; ++c) t.values[c] = invalid_digit;
+      for(int i = 0; i < 64; ++i)
+        t.values[static_cast<unsigned char>(base64_alphabet[i])] = static_cast<std::uint8_t>(i);
+      return t;
+    }
+    constexpr digit_table hex_table = make_hex_table();
+    constexpr digit_table base64_table = make_base64_table();
+
+    inline void encode_hex(const unsigned char* in, std::size_t size, char* out) noexcept
+    {
+#if defined(__SSE2__) || defined(_M_X64)
+      const __m128i mask = _mm_set1_epi8(0x0F);
+      const __m128i nine = _mm_set1_epi8(9);
+      const __m128i zero_char = _mm_set1_epi8('0');
+      const __m128i letter_offset = _mm_set1_epi8('a' - '0' - 10);
+      const auto to_ascii = [&](__m128i v) {
+        return _mm_add_epi8(_mm_add_epi8(v, zero_char), _mm_and_si128(_mm_cmpgt_epi8(v, nine), letter_offset));
+      };
+      for(; size >= 16; size -= 16, in += 16, out += 32) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+        const __m128i hi = to_ascii(_mm_and_si128(_mm_srli_epi16(v, 4), mask));
+        const __m128i lo = to_ascii(_mm_and_si128(v, mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_unpackhi_epi8(hi, lo));
+      }
+#endif
+      for(; size > 0; --size, ++in) {
+        *out++ = hex_digits[*in >> 4];
+        *out++ = hex_digits[*in & 0x0F];
+      }
+    }
+
+#if defined(__SSE2__) || defined(_M_X64)
+    // values of 16 hex digits; 'valid' is cleared for any other character
+    inline __m128i hex_nibbles(__m128i v, bool& valid) noexcept
+    {
+      const __m128i digit = _mm_sub_epi8(v, _mm_set1_epi8('0'));
+      const __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+      const __m128i letter = _mm_sub_epi8(_mm_or_si128(v, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+      const __m128i is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+      valid = valid && _mm_movemask_epi8(_mm_or_si128(is_digit, is_letter)) == 0xFFFF;
+      return _mm_or_si128(_mm_and_si128(is_digit, digit),
+                          _mm_and_si128(is_letter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+    }
+
+    // 16 nibbles to 8 bytes in the low half of the 16-bit lanes
+    inline __m128i hex_pairs(__m128i nibbles) noexcept
+    {
+      return _mm_or_si128(_mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00FF)), 4),
+                          _mm_srli_epi16(nibbles, 8));
+    }
+#endif
+
+    // decodes size / 2 bytes; returns false on a non-hex character
+    inline bool decode_hex(const char* in, std::size_t size, unsigned char* out) noexcept
+    {
+#if defined(__SSE2__) || defined(_M_X64)
+      bool valid = true;
+      for(; size >= 32; size -= 32, in += 32, out += 16) {
+        const __m128i a = hex_nibbles(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)), valid);
+        const __m128i b = hex_nibbles(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16)), valid);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(hex_pairs(a), hex_pairs(b)));
+      }
+      if(!valid) return false;
+#endif
+      for(; size >= 2; size -= 2, in += 2) {
+        const auto hi = hex_table.values[static_cast<unsigned char>(in[0])];
+        const auto lo = hex_table.values[static_cast<unsigned char>(in[1])];
+        if((hi | lo) == invalid_digit) return false;
+        *out++ = static_cast<unsigned char>(hi << 4 | lo);
+      }
+      return true;
+    }
+
+    inline void encode_base64(const unsigned char* in, std::size_t size, char* out) noexcept
+    {
+#if defined(__SSSE3__)
+      // W. Mula, "Base64 encoding with SIMD instructions": 12 bytes to 16 characters per step
+      for(; size >= 16; size -= 12, in += 12, out += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+        v = _mm_shuffle_epi8(v, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+        const __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(v, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+        const __m128i t1 = _mm_mullo_epi16(_mm_and_si128(v, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+        const __m128i indices = _mm_or_si128(t0, t1);
+        __m128i shift = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+        shift = _mm_or_si128(shift, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13)));
+        const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                              '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_add_epi8(_mm_shuffle_epi8(offsets, shift), indices));
+      }
+#endif
+      for(; size >= 3; size -= 3, in += 3) {
+        const std::uint32_t v = std::uint32_t{in[0]} << 16 | std::uint32_t{in[1]} << 8 | in[2];
+        *out++ = base64_alphabet[v >> 18];
+        *out++ = base64_alphabet[(v >> 12) & 0x3F];
+        *out++ = base64_alphabet[(v >> 6) & 0x3F];
+        *out++ = base64_alphabet[v & 0x3F];
+      }
+      if(size > 0) {
+        const std::uint32_t v = std::uint32_t{in[0]} << 16 | (size == 2 ? std::uint32_t{in[1]} << 8 : 0);
+        *out++ = base64_alphabet[v >> 18];
+        *out++ = base64_alphabet[(v >> 12) & 0x3F];
+        *out++ = size == 2 ? base64_alphabet[(v >> 6) & 0x3F] : '=';
+        *out = '=';
+      }
+    }
+
+    // decodes base64 text without padding (size % 4 != 1); returns false on a character outside the alphabet
+    inline bool decode_base64(const char* in, std::size_t size, unsigned char* out) noexcept
+    {
+#if defined(__SSSE3__)
+      // W. Mula, D. Lemire, "Faster Base64 Encoding and Decoding Using AVX2 Instructions" (SSSE3 variant):
+      // 16 characters to 12 bytes per step
+      const __m128i lut_lo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A,
+                                           0x1B, 0x1B, 0x1B, 0x1A);
+      const __m128i lut_hi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10,
+                                           0x10, 0x10, 0x10, 0x10);
+      const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+      const __m128i mask = _mm_set1_epi8(0x0F);
+      for(; size >= 16; size -= 16, in += 16, out += 12) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+        const __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(v, 4), mask);
+        const __m128i lo = _mm_shuffle_epi8(lut_lo, _mm_and_si128(v, mask));
+        const __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+        if(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0xFFFF) return false;
+        const __m128i eq_slash = _mm_cmpeq_epi8(v, _mm_set1_epi8('/'));
+        const __m128i values = _mm_add_epi8(v, _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_slash, hi_nibbles)));
+        const __m128i merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+        __m128i packed = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+        packed = _mm_shuffle_epi8(packed, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out), packed);
+        const auto tail = static_cast<std::uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(packed, 8)));
+        std::memcpy(out + 8, &tail, sizeof(tail));
+      }
+#endif
+      for(; size >= 4; size -= 4, in += 4) {
+        const std::uint32_t a = base64_table.values[static_cast<unsigned char>(in[0])];
+        const std::uint32_t b = base64_table.values[static_cast<unsigned char>(in[1])];
+        const std::uint32_t c = base64_table.values[static_cast<unsigned char>(in[2])];
+        const std::uint32_t d = base64_table.values[static_cast<unsigned char>(in[3])];
+        if((a | b | c | d) == invalid_digit) return false;
+        const std::uint32_t v = a << 18 | b << 12 | c << 6 | d;
+        *out++ = static_cast<unsigned char>(v >> 16);
+        *out++ = static_cast<unsigned char>(v >> 8);
+        *out++ = static_cast<unsigned char>(v);
+      }
+      if(size > 0) {
+        const std::uint32_t a = base64_table.values[static_cast<unsigned char>(in[0])];
+        const std::uint32_t b = base64_table.values[static_cast<unsigned char>(in[1])];
+        const std::uint32_t c = size == 3 ? base64_table.values[static_cast<unsigned char>(in[2])] : 0;
+        if((a | b | c) == invalid_digit) return false;
+        const std::uint32_t v = a << 18 | b << 12 | c << 6;
+        *out++ = static_cast<unsigned char>(v >> 16);
+        if(size == 3) *out = static_cast<unsigned char>(v >> 8);
+      }
+      return true;
+    }
+
+    inline std::size_t base64_padding(std::string_view text) noexcept
+    {
+      if(text.size() % 4 != 0 || text.empty()) return 0;
+      return text[text.size() - 1] != '=' ? 0 : text[text.size() - 2] != '=' ? 1 : 2;
+    }
+
+  }  // namespace detail
+
+  // encoding: appending to any char inplace string or returning a string of the exact worst-case capacity
+  template<std::size_t MaxSize, typename Traits>
+  void to_hex_append(basic_inplace_string<char, MaxSize, Traits>& out, const void* data, std::size_t size)
+  {
+    const auto n = 2 * size;
+    detail::encode_hex(static_cast<const unsigned char*>(data), size, out.append_uninitialized(n));
+    out.commit(n);
+  }
+
+  template<std::size_t MaxSize, typename Traits>
+  void to_base64_append(basic_inplace_string<char, MaxSize, Traits>& out, const void* data, std::size_t size)
+  {
+    const auto n = 4 * ((size + 2) / 3);
+    detail::encode_base64(static_cast<const unsigned char*>(data), size, out.append_uninitialized(n));
+    out.commit(n);
+  }
+
+  template<typename Byte, std::size_t N, detail::Requires<std::bool_constant<detail::is_byte<Byte>>> = true>
+  inplace_string<hex_encoded_capacity<N>> to_hex(const std::array<Byte, N>& bytes)
+  {
+    inplace_string<hex_encoded_capacity<N>> result;
+    to_hex_append(result, bytes.data(), N);
+    return result;
+  }
+  template<std::size_t N, typename Traits>
+  inplace_string<hex_encoded_capacity<N>> to_hex(const basic_inplace_string<char, N, Traits>& bytes)
+  {
+    inplace_string<hex_encoded_capacity<N>> result;
+    to_hex_append(result, bytes.data(), bytes.size());
+    return result;
+  }
+
+  template<typename Byte, std::size_t N, detail::Requires<std::bool_constant<detail::is_byte<Byte>>> = true>
+  inplace_string<base64_encoded_capacity<N>> to_base64(const std::array<Byte, N>& bytes)
+  {
+    inplace_string<base64_encoded_capacity<N>> result;
+    to_base64_append(result, bytes.data(), N);
+    return result;
+  }
+  template<std::size_t N, typename Traits>
+  inplace_string<base64_encoded_capacity<N>> to_base64(const basic_inplace_string<char, N, Traits>& bytes)
+  {
+    inplace_string<base64_encoded_capacity<N>> result;
+    to_base64_append(result, bytes.data(), bytes.size());
+    return result;
+  }
+
+  // decoding into a caller-supplied byte buffer; the value is the number of bytes written
+  inline parse_result<std::size_t> from_hex(std::string_view text, void* out, std::size_t capacity) noexcept
+  {
+    if(text.size() % 2 != 0) return {0, parse_status::invalid};
+    if(text.size() / 2 > capacity) return {0, parse_status::out_of_range};
+    if(!detail::decode_hex(text.data(), text.size(), static_cast<unsigned char*>(out)))
+      return {0, parse_status::invalid};
+    return {text.size() / 2, parse_status::ok};
+  }
+
+  // accepts padded and unpadded input
+  inline parse_result<std::size_t> from_base64(std::string_view text, void* out, std::size_t capacity) noexcept
+  {
+    text.remove_suffix(detail::base64_padding(text));
+    if(text.size() % 4 == 1) return {0, parse_status::invalid};
+    const std::size_t size = text.size() * 3 / 4;
+    if(size > capacity) return {0, parse_status::out_of_range};
+    if(!detail::decode_base64(text.data(), text.size(), static_cast<unsigned char*>(out)))
+      return {0, parse_status::invalid};
+    return {size, parse_status::ok};
+  }
+
+  // decoding into a char inplace string holding the bytes
+  template<std::size_t N, typename Traits>
+  parse_result<inplace_string<hex_decoded_capacity<N>>> from_hex(const basic_inplace_string<char, N, Traits>& text)
+  {
+    inplace_string<hex_decoded_capacity<N>> result;
+    parse_status status = parse_status::ok;
+    result.resize_and_overwrite(result.max_size(), [&](char* p, std::size_t n) {
+      const auto r = from_hex({text.data(), text.size()}, p, n);
+      status = r.status;
+      return r.value;
+    });
+    return {result, status};
+  }
+
+  template<std::size_t N, typename Traits>
+  parse_result<inplace_string<base64_decoded_capacity<N>>> from_base64(
+      const basic_inplace_string<char, N, Traits>& text)
+  {
+    inplace_string<base64_decoded_capacity<N>> result;
+    parse_status status = parse_status::ok;
+    result.resize_and_overwrite(result.max_size(), [&](char* p, std::size_t n) {
+      const auto r = from_base64({text.data(), text.size()}, p, n);
+      status = r.status;
+      return r.value;
+    });
+    return {result, status};
+  }
+
+}
@@ -0,0 +1,320 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <mp/inplace_string.h>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+// JSON string and CSV field escaping of char inplace strings.
+//
+// The result capacities are derived from the source capacity at compile time (the worst case of every
+// character escaped) and capped at the largest basic_inplace_string<char> capacity; when a capped
+// result does not fit std::length_error is thrown. Clean runs of characters are located with SSE2
+// (or 8 bytes at a time with SWAR arithmetic elsewhere) and copied in bulk.
+
+namespace mp {
+
+  namespace detail {
+
+    constexpr std::size_t max_char_inplace_size = std::numeric_limits<impl_size_type_helper<1>>::max();
+    constexpr std::size_t capped_inplace_size(std::size_t n)
+    {
+      return n < max_char_inplace_size ? n : max_char_inplace_size;
+    }
+
+    constexpr bool is_json_special(unsigned char c) { return c < 0x20 || c == '"' || c == '\\'; }
+    inline bool is_csv_special(unsigned char c, char delimiter)
+    {
+      return c == static_cast<unsigned char>(delimiter) || c == '"' || c == '\n' || c == '\r';
+    }
+
+    // SWAR: bytes of v lower than n (n <= 128) or equal to c have their high bit set in the result
+    constexpr std::uint64_t swar_less(std::uint64_t v, unsigned char n)
+    {
+      return (v - 0x0101010101010101ull * n) & ~v & 0x8080808080808080ull;
+    }
+    constexpr std::uint64_t swar_equal(std::uint64_t v, char c)
+    {
+      return swar_less(v ^ (0x0101010101010101ull * static_cast<unsigned char>(c)), 1);
+    }
+
+    // first character of [first, last) that needs JSON escaping
+    inline const char* find_json_special(const char* first, const char* last)
+    {
+#if defined(__SSE2__) || defined(_M_X64)
+      const __m128i quote = _mm_set1_epi8('"');
+      const __m128i backslash = _mm_set1_epi8('\\');
+      const __m128i control = _mm_set1_epi8(0x1F);
+      for(; last - first >= 16; first += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        const __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+                                             _mm_cmpeq_epi8(_mm_min_epu8(v, control), v));
+        if(_mm_movemask_epi8(special) != 0) break;
+      }
+#else
+      for(; last - first >= 8; first += 8) {
+        std::uint64_t v;
+        std::memcpy(&v, first, sizeof(v));
+        if((swar_less(v, 0x20) | swar_equal(v, '"') | swar_equal(v, '\\')) != 0) break;
+      }
+#endif
+      while(first != last && !is_json_special(static_cast<unsigned char>(*first))) ++first;
+      return first;
+    }
+
+    // first character of [first, last) that requires a CSV field to be quoted
+    inline const char* find_csv_special(const char* first, const char* last, char delimiter)
+    {
+#if defined(__SSE2__) || defined(_M_X64)
+      const __m128i delim = _mm_set1_epi8(delimiter);
+      const __m128i quote = _mm_set1_epi8('"');
+      const __m128i lf = _mm_set1_epi8('\n');
+      const __m128i cr = _mm_set1_epi8('\r');
+      for(; last - first >= 16; first += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        const __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, delim), _mm_cmpeq_epi8(v, quote)),
+                                             _mm_or_si128(_mm_cmpeq_epi8(v, lf), _mm_cmpeq_epi8(v, cr)));
+        if(_mm_movemask_epi8(special) != 0) break;
+      }
+#else
+      for(; last - first >= 8; first += 8) {
+        std::uint64_t v;
+        std::memcpy(&v, first, sizeof(v));
+        if((swar_equal(v, delimiter) | swar_equal(v, '"') | swar_equal(v, '\n') | swar_equal(v, '\r')) != 0) break;
+      }
+#endif
+      while(first != last && !is_csv_special(static_cast<unsigned char>(*first), delimiter)) ++first;
+      return first;
+    }
+
+    constexpr int hex_digit_value(char c)
+    {
+      return c >= '0' && c <= '9'   ? c - '0'
+             : c >= 'a' && c <= 'f' ? c - 'a' + 10
+             : c >= 'A' && c <= 'F' ? c - 'A' + 10
+                                    : -1;
+    }
+
+    // \uXXXX code unit or -1
+    inline long parse_json_code_unit(const char* p, const char* last)
+    {
+      if(last - p < 6 || p[0] != '\\' || p[1] != 'u') return -1;
+      long value = 0;
+      for(int i = 2; i < 6; ++i) {
+        const int digit = hex_digit_value(p[i]);
+        if(digit < 0) return -1;
+        value = value * 16 + digit;
+      }
+      return value;
+    }
+
+    template<std::size_t MaxSize, typename Traits>
+    void append_utf8(basic_inplace_string<char, MaxSize, Traits>& out, std::uint32_t cp)
+    {
+      char buffer[4];
+      std::size_t n;
+      if(cp < 0x80) {
+        buffer[0] = static_cast<char>(cp);
+        n = 1;
+      }
+      else if(cp < 0x800) {
+        buffer[0] = static_cast<char>(0xC0 | (cp >> 6));
+        buffer[1] = static_cast<char>(0x80 | (cp & 0x3F));
+        n = 2;
+      }
+      else if(cp < 0x10000) {
+        buffer[0] = static_cast<char>(0xE0 | (cp >> 12));
+        buffer[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        buffer[2] = static_cast<char>(0x80 | (cp & 0x3F));
+        n = 3;
+      }
+      else {
+        buffer[0] = static_cast<char>(0xF0 | (cp >> 18));
+        buffer[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        buffer[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        buffer[3] = static_cast<char>(0x80 | (cp & 0x3F));
+        n = 4;
+      }
+      out.append(buffer, n);
+    }
+
+  }  // namespace detail
+
+  template<std::size_t N>
+  constexpr std::size_t json_escaped_capacity = detail::capped_inplace_size(6 * N);  // every character as \u00XX
+  template<std::size_t N>
+  constexpr std::size_t csv_escaped_capacity = detail::capped_inplace_size(2 * N + 2);  // quotes and "" pairs
+
+  // Appends the contents of a JSON string (without the surrounding quotes): '"', '\' and control characters
+  // are escaped, other bytes (e.g. UTF-8 sequences) are copied unchanged.
+  template<std::size_t MaxSize, typename Traits>
+  void json_escape_append(basic_inplace_string<char, MaxSize, Traits>& out, std::string_view in)
+  {
+    const char* first = in.data();
+    const char* const last = first + in.size();
+    while(true) {
+      const char* special = detail::find_json_special(first, last);
+      out.append(first, static_cast<std::size_t>(special - first));
+      if(special == last) return;
+      const auto c = static_cast<unsigned char>(*special);
+      char escape[6] = {'\\', 0, '0', '0', 0, 0};
+      std::size_t n = 2;
+      switch(c) {
+        case '"': escape[1] = '"'; break;
+        case '\\': escape[1] = '\\'; break;
+        case '\b': escape[1] = 'b'; break;
+        case '\f': escape[1] = 'f'; break;
+        case '\n': escape[1] = 'n'; break;
+        case '\r': escape[1] = 'r'; break;
+        case '\t': escape[1] = 't'; break;
+        default:
+          escape[1] = 'u';
+          escape[4] = "0123456789abcdef"[c >> 4];
+          escape[5] = "0123456789abcdef"[c & 0xF];
+          n = 6;
+      }
+      out.append(escape, n);
+      first = special + 1;
+    }
+  }
+
+  template<std::size_t N, typename Traits>
+  inplace_string<json_escaped_capacity<N>> json_escape(const basic_inplace_string<char, N, Traits>& str)
+  {
+    inplace_string<json_escaped_capacity<N>> result;
+    json_escape_append(result, {str.data(), str.size()});
+    return result;
+  }
+
+  // Decodes the contents of a JSON string (without the surrounding quotes) including \uXXXX escapes
+  // (surrogate pairs become 4-byte UTF-8 sequences). The result is never longer than the source.
+  template<std::size_t N, typename Traits>
+  parse_result<basic_inplace_string<char, N, Traits>> json_unescape(const basic_inplace_string<char, N, Traits>& str)
+  {
+    using result_type = parse_result<basic_inplace_string<char, N, Traits>>;
+    basic_inplace_string<char, N, Traits> result;
+    const char* first = str.data();
+    const char* const last = first + str.size();
+    while(true) {
+      const auto backslash = static_cast<const char*>(std::memchr(first, '\\', static_cast<std::size_t>(last - first)));
+      const char* const run_end = backslash ? backslash : last;
+      result.append(first, static_cast<std::size_t>(run_end - first));
+      if(!backslash) return result_type{result, parse_status::ok};
+      if(last - backslash < 2) return result_type{{}, parse_status::invalid};
+      char c = 0;
+      switch(backslash[1]) {
+        case '"': c = '"'; break;
+        case '\\': c = '\\'; break;
+        case '/': c = '/'; break;
+        case 'b': c = '\b'; break;
+        case 'f': c = '\f'; break;
+        case 'n': c = '\n'; break;
+        case 'r': c = '\r'; break;
+        case 't': c = '\t'; break;
+        case 'u': {
+          const long unit = detail::parse_json_code_unit(backslash, last);
+          if(unit < 0 || (unit >= 0xDC00 && unit <= 0xDFFF)) return result_type{{}, parse_status::invalid};
+          if(unit >= 0xD800 && unit <= 0xDBFF) {
+            const long low = detail::parse_json_code_unit(backslash + 6, last);
+            if(low < 0xDC00 || low > 0xDFFF) return result_type{{}, parse_status::invalid};
+            detail::append_utf8(result, static_cast<std::uint32_t>(0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00)));
+            first = backslash + 12;
+          }
+          else {
+            detail::append_utf8(result, static_cast<std::uint32_t>(unit));
+            first = backslash + 6;
+          }
+          continue;
+        }
+        default: return result_type{{}, parse_status::invalid};
+      }
+      result.push_back(c);
+      first = backslash + 2;
+    }
+  }
+
+  // Appends a CSV field (RFC 4180): quoted, with '"' doubled, only if it contains the delimiter, '"', CR or LF.
+  template<std::size_t MaxSize, typename Traits>
+  void csv_escape_append(basic_inplace_string<char, MaxSize, Traits>& out, std::string_view in, char delimiter = ',')
+  {
+    const char* first = in.data();
+    const char* const last = first + in.size();
+    if(detail::find_csv_special(first, last, delimiter) == last) {
+      out.append(first, in.size());
+      return;
+    }
+    out.push_back('"');
+    while(true) {
+      const auto quote = static_cast<const char*>(std::memchr(first, '"', static_cast<std::size_t>(last - first)));
+      if(!quote) break;
+      out.append(first, static_cast<std::size_t>(quote - first + 1));
+      out.push_back('"');
+      first = quote + 1;
+    }
+    out.append(first, static_cast<std::size_t>(last - first));
+    out.push_back('"');
+  }
+
+  template<std::size_t N, typename Traits>
+  inplace_string<csv_escaped_capacity<N>> csv_escape(const basic_inplace_string<char, N, Traits>& str,
+                                                     char delimiter = ',')
+  {
+    inplace_string<csv_escaped_capacity<N>> result;
+    csv_escape_append(result, {str.data(), str.size()}, delimiter);
+    return result;
+  }
+
+  // Decodes a CSV field: a quoted field loses its quotes and "" pairs become '"'; an unquoted field is
+  // returned unchanged. A quote inside an unquoted field or an unpaired quote is invalid.
+  template<std::size_t N, typename Traits>
+  parse_result<basic_inplace_string<char, N, Traits>> csv_unescape(const basic_inplace_string<char, N, Traits>& str)
+  {
+    using result_type = parse_result<basic_inplace_string<char, N, Traits>>;
+    const char* first = str.data();
+    const char* last = first + str.size();
+    if(first == last || *first != '"') {
+      if(std::memchr(first, '"', str.size())) return result_type{{}, parse_status::invalid};
+      return result_type{str, parse_status::ok};
+    }
+    if(str.size() < 2 || last[-1] != '"') return result_type{{}, parse_status::invalid};
+    ++first;
+    --last;
+    basic_inplace_string<char, N, Traits> result;
+    while(true) {
+      const auto quote = static_cast<const char*>(std::memchr(first, '"', static_cast<std::size_t>(last - first)));
+      if(!quote) break;
+      if(quote + 1 == last || quote[1] != '"') return result_type{{}, parse_status::invalid};
+      result.append(first, static_cast<std::size_t>(quote - first + 1));
+      first = quote + 2;
+    }
+    result.append(first, static_cast<std::size_t>(last - first));
+    return result_type{result, parse_status::ok};
+  }
+
+}
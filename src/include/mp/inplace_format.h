@@ -0,0 +1,626 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <mp/inplace_string.h>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#if __has_include(<format>)
+#include <format>
+#endif
+
+// Type-safe formatting into basic_inplace_string:
+//
+//   const auto key = mp::format_to_inplace<32>("{}:{:08}", symbol, order_id);
+//
+// Replacement fields use a subset of the std::format syntax with automatic argument numbering only:
+//   {[:[[fill]align][sign][0][width][.precision][type]]}
+// with align '<', '>' or '^', sign '+', '-' or ' ' and type
+//   - integers: d (default), b, o, x, X
+//   - floating-point: f, F, e, E, g, G (shortest round-trip representation by default)
+//   - strings: s, characters: c, bool: s
+// The format string is parsed and checked against the argument types when the format_string object is
+// constructed: at compile time in C++20 (consteval) or when it is a constant expression (e.g. constexpr
+// variable) in C++17. Output is written directly into the in-place storage and throws std::length_error
+// when it does not fit.
+//
+// A "..."_fmt literal is parsed at compile time in every language mode and, when all the arguments have
+// a bounded length, the largest possible output is also checked against MaxSize at compile time:
+//
+//   using namespace mp::literals;
+//   const auto key = mp::format_to_inplace<24>("{}:{:08}"_fmt, symbol, order_id);
+//
+// If <fmt/format.h> (version 9 or later) is included before this header, fmt::formatter is specialized
+// for basic_inplace_string too.
+
+#if defined(__cpp_consteval)
+#define MP_FORMAT_CONSTEVAL consteval
+#else
+#define MP_FORMAT_CONSTEVAL constexpr
+#endif
+
+namespace mp {
+
+  namespace detail {
+
+    template<typename T>
+    struct type_identity {
+      using type = T;
+    };
+    template<typename T>
+    using type_identity_t = typename type_identity<T>::type;
+
+    template<typename T>
+    struct dependent_false : std::false_type {
+    };
+
+    constexpr std::size_t format_npos = static_cast<std::size_t>(-1);
+    constexpr std::size_t max_format_width = 4096;
+
+    enum class format_arg_kind : char { integer, boolean, character, floating, string };
+
+    // properties of an argument type used to validate the format and compute the maximum output size
+    struct format_arg_info {
+      format_arg_kind kind;
+      std::size_t bits = 0;             // integers: number of bits of the magnitude
+      std::size_t bound = format_npos;  // strings and floating-point: maximum length if known
+    };
+
+    template<typename T>
+    struct inplace_capacity : std::integral_constant<std::size_t, format_npos> {
+    };
+    template<typename CharT, std::size_t MaxSize, typename Traits>
+    struct inplace_capacity<basic_inplace_string<CharT, MaxSize, Traits>>
+        : std::integral_constant<std::size_t, MaxSize> {
+    };
+
+    template<typename CharT, typename T>
+    constexpr format_arg_info format_arg_info_of()
+    {
+      if constexpr(std::is_same_v<T, bool>)
+        return {format_arg_kind::boolean};
+      else if constexpr(std::is_same_v<T, CharT> || std::is_same_v<T, char>)
+        return {format_arg_kind::character};
+      else if constexpr(std::is_integral_v<T>) {
+        static_assert(sizeof(T) <= sizeof(std::uint64_t), "integers up to 64 bits supported");
+        constexpr auto bits = static_cast<std::size_t>(std::numeric_limits<std::make_unsigned_t<T>>::digits);
+        return {format_arg_kind::integer, bits};
+      }
+      else if constexpr(std::is_same_v<T, float> || std::is_same_v<T, double>)
+        return {format_arg_kind::floating, 0, max_float_chars<T>};
+      else if constexpr(std::is_array_v<T> && std::is_same_v<std::remove_extent_t<T>, CharT>)
+        return {format_arg_kind::string, 0, std::extent_v<T> - 1};
+      else if constexpr(std::is_convertible_v<const T&, std::basic_string_view<CharT>> ||
+                        std::is_convertible_v<const T&, const CharT*>)
+        return {format_arg_kind::string, 0, inplace_capacity<T>::value};
+      else
+        static_assert(dependent_false<T>::value, "unsupported format argument type");
+    }
+
+    template<typename CharT>
+    struct format_spec {
+      CharT fill = CharT(' ');
+      char align = 0;  // 0 when not given
+      char sign = '-';
+      bool zero = false;
+      std::size_t width = 0;
+      std::size_t precision = format_npos;
+      char type = 0;  // 0 when not given
+    };
+
+    // literal text of the format string; 'escaped' when it contains "{{" or "}}"
+    struct format_text {
+      std::size_t begin = 0;
+      std::size_t size = 0;
+      bool escaped = false;
+    };
+
+    template<typename CharT>
+    struct format_field {
+      format_text text;  // literal text preceding the replacement field
+      format_spec<CharT> spec;
+    };
+
+    constexpr std::size_t max_integer_chars(std::size_t bits, char type)
+    {
+      switch(type) {
+        case 'b': return bits;
+        case 'o': return (bits + 2) / 3;
+        case 'x':
+        case 'X': return (bits + 3) / 4;
+        default: return bits == 64 ? 20 : bits == 32 ? 10 : bits == 16 ? 5 : 3;
+      }
+    }
+
+    constexpr std::size_t max_field_chars(const format_arg_info& info, char type, std::size_t precision)
+    {
+      switch(info.kind) {
+        case format_arg_kind::integer: return 1 + max_integer_chars(info.bits, type);
+        case format_arg_kind::boolean: return 5;
+        case format_arg_kind::character: return 1;
+        case format_arg_kind::floating:
+          if(type == 'f' || type == 'F') return format_npos;
+          if(type == 0 && precision == format_npos) return info.bound;
+          // sign, digits, decimal point and exponent "e+308"
+          return 1 + (precision == format_npos ? 6 : precision) + 1 + 1 + 5;
+        case format_arg_kind::string: return precision < info.bound ? precision : info.bound;
+      }
+      return format_npos;
+    }
+
+    // writes [sign] body with the padding of the spec into the free capacity of 'out'
+    template<typename CharT, std::size_t MaxSize, typename Traits, typename BodyChar>
+    void write_padded(basic_inplace_string<CharT, MaxSize, Traits>& out, const format_spec<CharT>& spec,
+                      char default_align, char sign, const BodyChar* body, std::size_t size)
+    {
+      const std::size_t length = size + (sign != 0);
+      const std::size_t padding = spec.width > length ? spec.width - length : 0;
+      const bool zero_fill = spec.zero && spec.align == 0;
+      const char align = zero_fill ? '=' : spec.align != 0 ? spec.align : default_align;
+      const std::size_t left = align == '<' ? 0 : align == '^' ? padding / 2 : padding;
+      const std::size_t n = length + padding;
+      CharT* p = out.append_uninitialized(n);
+      if(!zero_fill) {
+        Traits::assign(p, left, spec.fill);
+        p += left;
+      }
+      if(sign != 0) Traits::assign(*p++, CharT(sign));
+      if(zero_fill) {
+        Traits::assign(p, left, CharT('0'));
+        p += left;
+      }
+      if constexpr(std::is_same_v<BodyChar, CharT>)
+        Traits::copy(p, body, size);
+      else
+        for(std::size_t i = 0; i < size; ++i) Traits::assign(p[i], static_cast<CharT>(body[i]));
+      Traits::assign(p + size, padding - left, spec.fill);
+      out.commit(n);
+    }
+
+    template<typename CharT, std::size_t MaxSize, typename Traits, typename Int>
+    void format_integer(basic_inplace_string<CharT, MaxSize, Traits>& out, const format_spec<CharT>& spec, Int value)
+    {
+      const bool negative = value < 0;
+      auto magnitude = static_cast<std::uint64_t>(value);
+      if(negative) magnitude = 0 - magnitude;
+      char buffer[64];
+      char* const last = buffer + sizeof(buffer);
+      char* first = last;
+      if(spec.type == 0 || spec.type == 'd') {
+        first -= count_digits(magnitude);
+        write_digits(last, magnitude, static_cast<std::size_t>(last - first));
+      }
+      else {
+        const char* const digits = spec.type == 'X' ? "0123456789ABCDEF" : "0123456789abcdef";
+        const unsigned shift = spec.type == 'b' ? 1 : spec.type == 'o' ? 3 : 4;
+        do {
+          *--first = digits[magnitude & ((1u << shift) - 1)];
+          magnitude >>= shift;
+        } while(magnitude != 0);
+      }
+      const char sign = negative ? '-' : spec.sign != '-' ? spec.sign : 0;
+      write_padded(out, spec, '>', sign, first, static_cast<std::size_t>(last - first));
+    }
+
+    template<typename CharT, std::size_t MaxSize, typename Traits, typename Float>
+    void format_floating(basic_inplace_string<CharT, MaxSize, Traits>& out, const format_spec<CharT>& spec,
+                         Float value)
+    {
+      const bool negative = std::signbit(value);
+      value = std::fabs(value);
+      char buffer[320];
+      char* last = nullptr;
+      const char type = spec.type;
+      if(type == 0 && spec.precision == format_npos)
+        last = format_shortest(buffer, buffer + sizeof(buffer), value);
+      else {
+        const int precision = spec.precision == format_npos ? 6 : static_cast<int>(spec.precision);
+#if defined(__cpp_lib_to_chars)
+        const auto format = type == 'f' || type == 'F'   ? std::chars_format::fixed
+                            : type == 'e' || type == 'E' ? std::chars_format::scientific
+                                                         : std::chars_format::general;
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, format, precision);
+        if(result.ec == std::errc{}) last = result.ptr;
+#else
+        const char* const format = type == 'f' || type == 'F' ? "%.*f" : type == 'e' || type == 'E' ? "%.*e" : "%.*g";
+        const int length = std::snprintf(buffer, sizeof(buffer), format, precision, static_cast<double>(value));
+        if(length >= 0 && static_cast<std::size_t>(length) < sizeof(buffer)) last = buffer + length;
+#endif
+      }
+      if(!last) throw std::length_error("mp::format_to_inplace: formatted value too long");
+      if(type == 'F' || type == 'E' || type == 'G')
+        for(char* p = buffer; p != last; ++p)
+          if(*p >= 'a' && *p <= 'z') *p = static_cast<char>(*p - 'a' + 'A');
+      const char sign = negative ? '-' : spec.sign != '-' ? spec.sign : 0;
+      write_padded(out, spec, '>', sign, buffer, static_cast<std::size_t>(last - buffer));
+    }
+
+    template<typename CharT, std::size_t MaxSize, typename Traits, typename T>
+    void format_arg(basic_inplace_string<CharT, MaxSize, Traits>& out, const format_spec<CharT>& spec, const T& arg)
+    {
+      constexpr format_arg_info info = format_arg_info_of<CharT, T>();
+      if constexpr(info.kind == format_arg_kind::integer)
+        format_integer(out, spec, arg);
+      else if constexpr(info.kind == format_arg_kind::floating)
+        format_floating(out, spec, arg);
+      else if constexpr(info.kind == format_arg_kind::boolean)
+        write_padded(out, spec, '<', 0, arg ? "true" : "false", arg ? 4 : 5);
+      else if constexpr(info.kind == format_arg_kind::character) {
+        const CharT c = static_cast<CharT>(arg);
+        write_padded(out, spec, '<', 0, &c, 1);
+      }
+      else {
+        std::basic_string_view<CharT> sv;
+        if constexpr(std::is_convertible_v<const T&, std::basic_string_view<CharT>>)
+          sv = arg;
+        else
+          sv = static_cast<const CharT*>(arg);
+        if(spec.precision < sv.size()) sv = sv.substr(0, spec.precision);
+        write_padded(out, spec, '<', 0, sv.data(), sv.size());
+      }
+    }
+
+  }  // namespace detail
+
+  // Format string parsed and checked against Args on construction
+  template<typename CharT, typename... Args>
+  class basic_format_string {
+    static constexpr std::array<detail::format_arg_info, sizeof...(Args)> infos_ = {
+        detail::format_arg_info_of<CharT, std::remove_cv_t<std::remove_reference_t<Args>>>()...};
+
+  public:
+    template<std::size_t N>
+    MP_FORMAT_CONSTEVAL basic_format_string(const CharT (&str)[N]) : str_{str, N - 1}
+    {
+      parse();
+    }
+
+    constexpr std::basic_string_view<CharT> get() const noexcept { return str_; }
+
+    // the largest possible output or static_cast<std::size_t>(-1) if the arguments have no bound
+    // (e.g. std::string_view or fixed notation of floating-point values)
+    constexpr std::size_t max_size() const noexcept
+    {
+      std::size_t total = text_chars_;
+      for(std::size_t i = 0; i < field_count_; ++i) {
+        const auto& spec = fields_[i].spec;
+        const auto chars = detail::max_field_chars(infos_[i], spec.type, spec.precision);
+        if(chars == detail::format_npos) return detail::format_npos;
+        total += chars > spec.width ? chars : spec.width;
+      }
+      return total;
+    }
+
+    template<std::size_t MaxSize, typename Traits>
+    void format_to(basic_inplace_string<CharT, MaxSize, Traits>& out, const Args&... args) const
+    {
+      [[maybe_unused]] std::size_t i = 0;
+      (
+          [&](const auto& arg) {
+            if(i < field_count_) {
+              write_text(out, fields_[i].text);
+              detail::format_arg(out, fields_[i].spec, arg);
+              ++i;
+            }
+          }(args),
+          ...);
+      write_text(out, tail_);
+    }
+
+  private:
+    std::basic_string_view<CharT> str_;
+    std::array<detail::format_field<CharT>, sizeof...(Args)> fields_{};
+    detail::format_text tail_{};
+    std::size_t field_count_ = 0;
+    std::size_t text_chars_ = 0;
+
+    constexpr void parse()
+    {
+      const std::size_t n = str_.size();
+      detail::format_text text;
+      std::size_t i = 0;
+      while(i < n) {
+        const CharT c = str_[i];
+        if(c == CharT('{') || c == CharT('}')) {
+          if(i + 1 < n && str_[i + 1] == c) {
+            text.escaped = true;
+            ++text_chars_;
+            i += 2;
+            continue;
+          }
+          if(c == CharT('}')) throw std::invalid_argument("mp::format_string: unmatched '}' in format string");
+          if(field_count_ == sizeof...(Args)) throw std::invalid_argument("mp::format_string: not enough arguments");
+          text.size = i - text.begin;
+          fields_[field_count_].text = text;
+          i = parse_field(i + 1, fields_[field_count_].spec, infos_[field_count_]);
+          ++field_count_;
+          text = {i, 0, false};
+        }
+        else {
+          ++text_chars_;
+          ++i;
+        }
+      }
+      text.size = n - text.begin;
+      tail_ = text;
+    }
+
+    constexpr bool is_digit(std::size_t i) const
+    {
+      return i < str_.size() && str_[i] >= CharT('0') && str_[i] <= CharT('9');
+    }
+    constexpr bool is(std::size_t i, char c) const { return i < str_.size() && str_[i] == CharT(c); }
+
+    constexpr std::size_t parse_number(std::size_t& i) const
+    {
+      std::size_t value = 0;
+      for(; is_digit(i); ++i) {
+        value = value * 10 + static_cast<std::size_t>(str_[i] - CharT('0'));
+        if(value > detail::max_format_width)
+          throw std::invalid_argument("mp::format_string: width or precision too large");
+      }
+      return value;
+    }
+
+    constexpr std::size_t parse_field(std::size_t i, detail::format_spec<CharT>& spec,
+                                      const detail::format_arg_info& info) const
+    {
+      if(is_digit(i)) throw std::invalid_argument("mp::format_string: manual argument indexing is not supported");
+      if(is(i, ':')) {
+        ++i;
+        const auto at = [&](std::size_t j) { return j < str_.size() ? str_[j] : CharT(); };
+        if(at(i) != CharT('{') && at(i) != CharT('}') && (is(i + 1, '<') || is(i + 1, '>') || is(i + 1, '^'))) {
+          spec.fill = str_[i];
+          spec.align = static_cast<char>(str_[i + 1]);
+          i += 2;
+        }
+        else if(is(i, '<') || is(i, '>') || is(i, '^'))
+          spec.align = static_cast<char>(str_[i++]);
+        if(is(i, '+') || is(i, '-') || is(i, ' ')) spec.sign = static_cast<char>(str_[i++]);
+        if(is(i, '0')) {
+          spec.zero = true;
+          ++i;
+        }
+        spec.width = parse_number(i);
+        if(is(i, '.')) {
+          ++i;
+          if(!is_digit(i)) throw std::invalid_argument("mp::format_string: missing precision");
+          spec.precision = parse_number(i);
+        }
+        if(i < str_.size() && !is(i, '}')) {
+          const CharT type = str_[i++];
+          spec.type = type >= CharT('A') && type <= CharT('z') ? static_cast<char>(type) : '?';
+        }
+      }
+      if(!is(i, '}')) throw std::invalid_argument("mp::format_string: invalid replacement field");
+      validate(spec, info);
+      return i + 1;
+    }
+
+    static constexpr void validate(const detail::format_spec<CharT>& spec, const detail::format_arg_info& info)
+    {
+      using detail::format_arg_kind;
+      const bool numeric = info.kind == format_arg_kind::integer || info.kind == format_arg_kind::floating;
+      if(!numeric && (spec.zero || spec.sign != '-'))
+        throw std::invalid_argument("mp::format_string: sign and '0' apply only to numbers");
+      if(spec.precision != detail::format_npos && info.kind != format_arg_kind::floating &&
+         info.kind != format_arg_kind::string)
+        throw std::invalid_argument("mp::format_string: precision applies only to floating-point and strings");
+      const char t = spec.type;
+      bool valid = t == 0;
+      switch(info.kind) {
+        case format_arg_kind::integer:
+          valid |= t == 'd' || t == 'b' || t == 'o' || t == 'x' || t == 'X';
+          break;
+        case format_arg_kind::floating:
+          valid |= t == 'f' || t == 'F' || t == 'e' || t == 'E' || t == 'g' || t == 'G';
+          break;
+        case format_arg_kind::character: valid |= t == 'c'; break;
+        case format_arg_kind::boolean:
+        case format_arg_kind::string: valid |= t == 's'; break;
+      }
+      if(!valid) throw std::invalid_argument("mp::format_string: invalid type for the argument");
+    }
+
+    template<std::size_t MaxSize, typename Traits>
+    void write_text(basic_inplace_string<CharT, MaxSize, Traits>& out, const detail::format_text& text) const
+    {
+      const CharT* p = str_.data() + text.begin;
+      if(!text.escaped) {
+        out.append(p, text.size);
+        return;
+      }
+      for(const CharT* const last = p + text.size; p != last; ++p) {
+        out.push_back(*p);
+        if(*p == CharT('{') || *p == CharT('}')) ++p;  // skip the second character of an escape
+      }
+    }
+  };
+
+  template<typename... Args>
+  using format_string = basic_format_string<char, detail::type_identity_t<Args>...>;
+  template<typename... Args>
+  using wformat_string = basic_format_string<wchar_t, detail::type_identity_t<Args>...>;
+
+  // type of a "..."_fmt literal carrying its characters in the type
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+  template<detail::literal_chars Str>
+  struct format_literal {
+    using char_type = typename decltype(Str)::char_type;
+    static constexpr const auto& chars = Str.chars;
+  };
+#else
+  template<typename CharT, CharT... Chars>
+  struct format_literal {
+    using char_type = CharT;
+    static constexpr CharT chars[] = {Chars..., CharT{}};
+  };
+#endif
+
+  namespace detail {
+    template<typename T>
+    struct is_format_literal : std::false_type {
+    };
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+    template<literal_chars Str>
+    struct is_format_literal<format_literal<Str>> : std::true_type {
+    };
+#else
+    template<typename CharT, CharT... Chars>
+    struct is_format_literal<format_literal<CharT, Chars...>> : std::true_type {
+    };
+#endif
+
+    // constant initialization forces the parse (and any format error) to happen at compile time
+    template<typename Literal, typename... Args>
+    inline constexpr basic_format_string<typename Literal::char_type, Args...> literal_format{Literal::chars};
+
+    template<std::size_t MaxSize, typename Literal, typename... Args>
+    constexpr void check_literal_format_size()
+    {
+      constexpr std::size_t size = literal_format<Literal, Args...>.max_size();
+      static_assert(size == format_npos || size <= MaxSize, "formatted output may not fit in MaxSize characters");
+    }
+  }
+
+  template<std::size_t MaxSize, typename... Args>
+  basic_inplace_string<char, MaxSize> format_to_inplace(format_string<Args...> fmt, const Args&... args)
+  {
+    basic_inplace_string<char, MaxSize> result;
+    fmt.format_to(result, args...);
+    return result;
+  }
+
+  template<std::size_t MaxSize, typename... Args>
+  basic_inplace_string<wchar_t, MaxSize> format_to_inplace(wformat_string<Args...> fmt, const Args&... args)
+  {
+    basic_inplace_string<wchar_t, MaxSize> result;
+    fmt.format_to(result, args...);
+    return result;
+  }
+
+  // appends the formatted output to an existing string
+  template<std::size_t MaxSize, typename Traits, typename... Args>
+  basic_inplace_string<char, MaxSize, Traits>& format_append(basic_inplace_string<char, MaxSize, Traits>& str,
+                                                             format_string<Args...> fmt, const Args&... args)
+  {
+    fmt.format_to(str, args...);
+    return str;
+  }
+
+  template<std::size_t MaxSize, typename Traits, typename... Args>
+  basic_inplace_string<wchar_t, MaxSize, Traits>& format_append(basic_inplace_string<wchar_t, MaxSize, Traits>& str,
+                                                                wformat_string<Args...> fmt, const Args&... args)
+  {
+    fmt.format_to(str, args...);
+    return str;
+  }
+
+  // "..."_fmt overloads: the format is parsed and its largest output checked against MaxSize at compile time
+  template<std::size_t MaxSize, typename Literal, typename... Args,
+           detail::Requires<detail::is_format_literal<Literal>> = true>
+  basic_inplace_string<typename Literal::char_type, MaxSize> format_to_inplace(Literal, const Args&... args)
+  {
+    detail::check_literal_format_size<MaxSize, Literal, Args...>();
+    basic_inplace_string<typename Literal::char_type, MaxSize> result;
+    detail::literal_format<Literal, Args...>.format_to(result, args...);
+    return result;
+  }
+
+  // only the characters written by this call are checked against MaxSize, not the current size of 'str'
+  template<std::size_t MaxSize, typename Traits, typename Literal, typename... Args,
+           detail::Requires<detail::is_format_literal<Literal>> = true>
+  basic_inplace_string<typename Literal::char_type, MaxSize, Traits>& format_append(
+      basic_inplace_string<typename Literal::char_type, MaxSize, Traits>& str, Literal, const Args&... args)
+  {
+    detail::check_literal_format_size<MaxSize, Literal, Args...>();
+    detail::literal_format<Literal, Args...>.format_to(str, args...);
+    return str;
+  }
+
+  // literals
+  inline namespace literals {
+    inline namespace format_literals {
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+      template<detail::literal_chars Str>
+      constexpr format_literal<Str> operator""_fmt()
+      {
+        return {};
+      }
+#elif defined(__GNUC__)
+#pragma GCC diagnostic push
+#if defined(__clang__)
+#pragma GCC diagnostic ignored "-Wgnu-string-literal-operator-template"
+#else
+#pragma GCC diagnostic ignored "-Wpedantic"
+#endif
+      template<typename CharT, CharT... Chars>
+      constexpr format_literal<CharT, Chars...> operator""_fmt()
+      {
+        return {};
+      }
+#pragma GCC diagnostic pop
+#endif
+    }
+  }
+
+}
+
+#if defined(__cpp_lib_format)
+namespace std {
+
+  template<typename CharT, std::size_t MaxSize, typename Traits>
+  struct formatter<mp::basic_inplace_string<CharT, MaxSize, Traits>, CharT>
+      : formatter<basic_string_view<CharT>, CharT> {
+    template<typename FormatContext>
+    auto format(const mp::basic_inplace_string<CharT, MaxSize, Traits>& str, FormatContext& ctx) const
+    {
+      return formatter<basic_string_view<CharT>, CharT>::format(basic_string_view<CharT>{str.data(), str.size()}, ctx);
+    }
+  };
+
+}
+#endif
+
+#if defined(FMT_VERSION) && FMT_VERSION >= 90000
+namespace fmt {
+
+  template<typename CharT, std::size_t MaxSize, typename Traits>
+  struct formatter<mp::basic_inplace_string<CharT, MaxSize, Traits>, CharT>
+      : formatter<basic_string_view<CharT>, CharT> {
+    template<typename FormatContext>
+    auto format(const mp::basic_inplace_string<CharT, MaxSize, Traits>& str, FormatContext& ctx) const
+        -> decltype(ctx.out())
+    {
+      return formatter<basic_string_view<CharT>, CharT>::format(basic_string_view<CharT>{str.data(), str.size()}, ctx);
+    }
+  };
+
+}
+#endif
@@ -0,0 +1,257 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <mp/inplace_codec.h>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+// Binary UUID, IPv4 and IPv6 values and their canonical text forms. Every text form has a fixed upper bound
+// (36, 15 and 45 characters), so formatting returns an inplace_string of exactly that capacity.
+//
+// UUID and IPv6 formatting convert all 16 bytes to hex in one SIMD pass (see inplace_codec.h) and then only
+// move digits around; IPv4 octets come from a 256-entry table. Parsers follow inet_pton() rules.
+
+namespace mp {
+
+  struct uuid {
+    std::array<std::uint8_t, 16> bytes{};
+  };
+
+  struct ipv4_address {
+    std::array<std::uint8_t, 4> bytes{};
+  };
+
+  struct ipv6_address {
+    std::array<std::uint8_t, 16> bytes{};
+  };
+
+  inline bool operator==(const uuid& lhs, const uuid& rhs) noexcept { return lhs.bytes == rhs.bytes; }
+  inline bool operator!=(const uuid& lhs, const uuid& rhs) noexcept { return lhs.bytes != rhs.bytes; }
+  inline bool operator==(const ipv4_address& lhs, const ipv4_address& rhs) noexcept { return lhs.bytes == rhs.bytes; }
+  inline bool operator!=(const ipv4_address& lhs, const ipv4_address& rhs) noexcept { return lhs.bytes != rhs.bytes; }
+  inline bool operator==(const ipv6_address& lhs, const ipv6_address& rhs) noexcept { return lhs.bytes == rhs.bytes; }
+  inline bool operator!=(const ipv6_address& lhs, const ipv6_address& rhs) noexcept { return lhs.bytes != rhs.bytes; }
+
+  namespace detail {
+
+    // decimal digits of every octet padded to 3 characters, with the digit count in the last byte
+    struct octet_table {
+      char entries[256][4] = {};
+    };
+
+    constexpr octet_table make_octet_table()
+    {
+      octet_table t;
+      for(int i = 0; i < 256; ++i) {
+        auto& e = t.entries[i];
+        const int count = i >= 100 ? 3 : i >= 10 ? 2 : 1;
+        for(int d = count - 1, v = i; d >= 0; --d, v /= 10) e[d] = static_cast<char>('0' + v % 10);
+        e[3] = static_cast<char>(count);
+      }
+      return t;
+    }
+    constexpr octet_table octets = make_octet_table();
+
+    // writes up to 15 characters but needs 16 bytes of room
+    inline char* write_ipv4(char* out, const std::uint8_t* bytes) noexcept
+    {
+      for(int i = 0; i < 4; ++i) {
+        const auto& e = octets.entries[bytes[i]];
+        std::memcpy(out, e, 4);
+        out += e[3];
+        *out = '.';
+        out += i < 3;
+      }
+      return out;
+    }
+
+  }  // namespace detail
+
+  // formatting
+  inline inplace_string<36> to_string(const uuid& id)
+  {
+    char hex[32];
+    detail::encode_hex(id.bytes.data(), id.bytes.size(), hex);
+    inplace_string<36> result;
+    char* out = result.append_uninitialized(36);
+    std::memcpy(out, hex, 8);
+    std::memcpy(out + 9, hex + 8, 4);
+    std::memcpy(out + 14, hex + 12, 4);
+    std::memcpy(out + 19, hex + 16, 4);
+    std::memcpy(out + 24, hex + 20, 12);
+    out[8] = out[13] = out[18] = out[23] = '-';
+    result.commit(36);
+    return result;
+  }
+
+  inline inplace_string<15> to_string(const ipv4_address& addr)
+  {
+    char buf[16];
+    const char* const last = detail::write_ipv4(buf, addr.bytes.data());
+    return inplace_string<15>(buf, static_cast<std::size_t>(last - buf));
+  }
+
+  // RFC 5952 form as produced by inet_ntop(): lowercase digits without leading zeros, the first longest run of
+  // two or more zero groups replaced with "::", IPv4-mapped and IPv4-compatible addresses in dotted form
+  inline inplace_string<45> to_string(const ipv6_address& addr)
+  {
+    char hex[36] = {};  // every group is copied as 4 bytes, so the last one may read past the digits
+    detail::encode_hex(addr.bytes.data(), addr.bytes.size(), hex);
+    std::uint16_t words[8];
+    for(int i = 0; i < 8; ++i) words[i] = static_cast<std::uint16_t>(addr.bytes[2 * i] << 8 | addr.bytes[2 * i + 1]);
+
+    int best_base = -1, best_len = 0;
+    for(int i = 0; i < 8;) {
+      int j = i;
+      while(j < 8 && words[j] == 0) ++j;
+      if(j - i > best_len) {
+        best_base = i;
+        best_len = j - i;
+      }
+      i = j + 1;
+    }
+    if(best_len < 2) best_base = -1;
+
+    char buf[48];
+    char* out = buf;
+    for(int i = 0; i < 8; ++i) {
+      if(best_base >= 0 && i >= best_base && i < best_base + best_len) {
+        if(i == best_base) *out++ = ':';
+        continue;
+      }
+      if(i != 0) *out++ = ':';
+      if(i == 6 && best_base == 0 && (best_len == 6 || (best_len == 5 && words[5] == 0xFFFF))) {
+        out = detail::write_ipv4(out, addr.bytes.data() + 12);
+        break;
+      }
+      const int count = 1 + (words[i] > 0xF) + (words[i] > 0xFF) + (words[i] > 0xFFF);
+      std::memcpy(out, hex + 4 * i + 4 - count, 4);
+      out += count;
+    }
+    if(best_base >= 0 && best_base + best_len == 8) *out++ = ':';
+    return inplace_string<45>(buf, static_cast<std::size_t>(out - buf));
+  }
+
+  // parsing
+  // 8-4-4-4-12 hex digits in either case
+  inline parse_result<uuid> parse_uuid(std::string_view text) noexcept
+  {
+    if(text.size() != 36 || text[8] != '-' || text[13] != '-' || text[18] != '-' || text[23] != '-')
+      return {{}, parse_status::invalid};
+    char hex[32];
+    std::memcpy(hex, text.data(), 8);
+    std::memcpy(hex + 8, text.data() + 9, 4);
+    std::memcpy(hex + 12, text.data() + 14, 4);
+    std::memcpy(hex + 16, text.data() + 19, 4);
+    std::memcpy(hex + 20, text.data() + 24, 12);
+    uuid id;
+    if(!detail::decode_hex(hex, sizeof(hex), id.bytes.data())) return {{}, parse_status::invalid};
+    return {id, parse_status::ok};
+  }
+
+  // dotted decimal with exactly 4 octets and no leading zeros
+  inline parse_result<ipv4_address> parse_ipv4(std::string_view text) noexcept
+  {
+    if(text.size() < 7 || text.size() > 15) return {{}, parse_status::invalid};
+    const char* p = text.data();
+    const char* const end = p + text.size();
+    ipv4_address addr;
+    for(std::size_t i = 0; i < 4; ++i) {
+      if(i != 0 && (p == end || *p++ != '.')) return {{}, parse_status::invalid};
+      const char* const first = p;
+      unsigned v = 0;
+      while(p != end && p - first < 3 && static_cast<unsigned>(*p - '0') < 10)
+        v = v * 10 + static_cast<unsigned>(*p++ - '0');
+      if(p == first || v > 255 || (*first == '0' && p - first > 1)) return {{}, parse_status::invalid};
+      addr.bytes[i] = static_cast<std::uint8_t>(v);
+    }
+    if(p != end) return {{}, parse_status::invalid};
+    return {addr, parse_status::ok};
+  }
+
+  // groups of 1 to 4 hex digits, at most one "::" and an optional trailing dotted IPv4 address
+  inline parse_result<ipv6_address> parse_ipv6(std::string_view text) noexcept
+  {
+    if(text.size() < 2 || text.size() > 45) return {{}, parse_status::invalid};
+    const char* p = text.data();
+    const char* const end = p + text.size();
+    if(*p == ':' && *++p != ':') return {{}, parse_status::invalid};
+
+    ipv6_address addr;
+    std::uint8_t* out = addr.bytes.data();
+    std::uint8_t* const out_end = out + addr.bytes.size();
+    std::uint8_t* gap = nullptr;
+    const char* group = p;
+    unsigned value = 0;
+    int digits = 0;
+    while(p != end) {
+      const char ch = *p++;
+      const auto d = detail::hex_table.values[static_cast<unsigned char>(ch)];
+      if(d != detail::invalid_digit) {
+        if(++digits > 4) return {{}, parse_status::invalid};
+        value = value << 4 | d;
+      }
+      else if(ch == ':') {
+        group = p;
+        if(digits == 0) {
+          if(gap) return {{}, parse_status::invalid};
+          gap = out;
+          continue;
+        }
+        if(p == end || out_end - out < 2) return {{}, parse_status::invalid};
+        *out++ = static_cast<std::uint8_t>(value >> 8);
+        *out++ = static_cast<std::uint8_t>(value);
+        value = 0;
+        digits = 0;
+      }
+      else if(ch == '.' && out_end - out >= 4) {
+        const auto v4 = parse_ipv4({group, static_cast<std::size_t>(end - group)});
+        if(!v4) return {{}, parse_status::invalid};
+        std::memcpy(out, v4.value.bytes.data(), 4);
+        out += 4;
+        digits = 0;
+        break;
+      }
+      else
+        return {{}, parse_status::invalid};
+    }
+    if(digits != 0) {
+      if(out_end - out < 2) return {{}, parse_status::invalid};
+      *out++ = static_cast<std::uint8_t>(value >> 8);
+      *out++ = static_cast<std::uint8_t>(value);
+    }
+    if(gap) {
+      if(out == out_end) return {{}, parse_status::invalid};
+      const auto tail = static_cast<std::size_t>(out - gap);
+      std::memmove(out_end - tail, gap, tail);
+      std::memset(gap, 0, static_cast<std::size_t>(out_end - tail - gap));
+      out = out_end;
+    }
+    if(out != out_end) return {{}, parse_status::invalid};
+    return {addr, parse_status::ok};
+  }
+
+}
@@ -0,0 +1,194 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <mp/inplace_string.h>
+#include <algorithm>
+#include <ios>
+#include <ostream>
+#include <streambuf>
+#include <string_view>
+
+namespace mp {
+
+  // what happens to output that does not fit into MaxSize characters
+  enum class inplace_overflow {
+    fail,     // the write fails and the stream sets badbit (so fail() is true)
+    truncate  // the excess is discarded, the stream stays good and truncated() reports it
+  };
+
+  // A stream buffer whose put area is the in-place storage of a basic_inplace_string so that
+  // operator<< based formatting produces an inplace string without any heap allocation.
+  //
+  // Characters are written straight into the string storage and its size is updated from the
+  // put pointer only when the content is requested.
+  template<typename CharT, std::size_t MaxSize, typename Traits = std::char_traits<std::decay_t<CharT>>>
+  class basic_inplace_stringbuf : public std::basic_streambuf<CharT, Traits> {
+    using base = std::basic_streambuf<CharT, Traits>;
+
+  public:
+    using char_type = CharT;
+    using traits_type = Traits;
+    using int_type = typename Traits::int_type;
+    using pos_type = typename Traits::pos_type;
+    using off_type = typename Traits::off_type;
+    using string_type = basic_inplace_string<CharT, MaxSize, Traits>;
+    using string_view_type = std::basic_string_view<CharT, Traits>;
+
+    explicit basic_inplace_stringbuf(inplace_overflow policy = inplace_overflow::fail) : policy_{policy} { reset(0); }
+    explicit basic_inplace_stringbuf(string_view_type sv, inplace_overflow policy = inplace_overflow::fail)
+        : policy_{policy}
+    {
+      str(sv);
+    }
+    basic_inplace_stringbuf(const basic_inplace_stringbuf&) = delete;
+    basic_inplace_stringbuf& operator=(const basic_inplace_stringbuf&) = delete;
+
+    // the text written so far
+    const string_type& str() const
+    {
+      str_.resize_and_overwrite(size(), [](CharT*, std::size_t n) { return n; });
+      return str_;
+    }
+    string_view_type view() const { return {this->pbase(), size()}; }
+
+    // replaces the content; subsequent output is appended to it
+    void str(string_view_type sv)
+    {
+      if(sv.size() > MaxSize) throw std::length_error("basic_inplace_stringbuf::str: string too long");
+      str_.assign(sv);
+      reset(sv.size());
+    }
+
+    bool truncated() const { return truncated_; }
+    inplace_overflow policy() const { return policy_; }
+
+  protected:
+    int_type overflow(int_type c) override
+    {
+      if(traits_type::eq_int_type(c, traits_type::eof())) return traits_type::not_eof(c);
+      if(this->pptr() < this->epptr()) {
+        *this->pptr() = traits_type::to_char_type(c);
+        this->pbump(1);
+        return c;
+      }
+      return on_overflow(c);
+    }
+
+    std::streamsize xsputn(const char_type* s, std::streamsize count) override
+    {
+      const auto n = std::min<std::streamsize>(count, this->epptr() - this->pptr());
+      traits_type::copy(this->pptr(), s, static_cast<std::size_t>(n));
+      this->pbump(static_cast<int>(n));
+      if(n == count) return n;
+      return traits_type::eq_int_type(on_overflow(traits_type::to_int_type(s[n])), traits_type::eof()) ? n : count;
+    }
+
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                     std::ios_base::openmode which = std::ios_base::in | std::ios_base::out) override
+    {
+      if(!(which & std::ios_base::out)) return pos_type(off_type(-1));
+      const auto end = static_cast<off_type>(size());
+      high_water_ = size();
+      off_type pos = off;
+      if(dir == std::ios_base::cur)
+        pos += static_cast<off_type>(this->pptr() - this->pbase());
+      else if(dir == std::ios_base::end)
+        pos += end;
+      if(pos < 0 || pos > end) return pos_type(off_type(-1));
+      this->setp(this->pbase(), this->epptr());
+      this->pbump(static_cast<int>(pos));
+      return pos_type(pos);
+    }
+
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which = std::ios_base::in | std::ios_base::out) override
+    {
+      return seekoff(off_type(pos), std::ios_base::beg, which);
+    }
+
+  private:
+    mutable string_type str_;
+    std::size_t high_water_ = 0;
+    inplace_overflow policy_;
+    bool truncated_ = false;
+
+    std::size_t size() const
+    {
+      return std::max(high_water_, static_cast<std::size_t>(this->pptr() - this->pbase()));
+    }
+
+    void reset(std::size_t size)
+    {
+      this->setp(str_.data(), str_.data() + MaxSize);
+      this->pbump(static_cast<int>(size));
+      high_water_ = size;
+      truncated_ = false;
+    }
+
+    int_type on_overflow(int_type c)
+    {
+      if(policy_ == inplace_overflow::fail) return traits_type::eof();
+      truncated_ = true;
+      return c;
+    }
+  };
+
+  // An output stream formatting into a basic_inplace_stringbuf
+  template<typename CharT, std::size_t MaxSize, typename Traits = std::char_traits<std::decay_t<CharT>>>
+  class basic_inplace_ostream : public std::basic_ostream<CharT, Traits> {
+  public:
+    using stringbuf_type = basic_inplace_stringbuf<CharT, MaxSize, Traits>;
+    using string_type = typename stringbuf_type::string_type;
+    using string_view_type = typename stringbuf_type::string_view_type;
+
+    explicit basic_inplace_ostream(inplace_overflow policy = inplace_overflow::fail)
+        : std::basic_ostream<CharT, Traits>{nullptr}, buf_{policy}
+    {
+      this->init(&buf_);
+    }
+    explicit basic_inplace_ostream(string_view_type sv, inplace_overflow policy = inplace_overflow::fail)
+        : std::basic_ostream<CharT, Traits>{nullptr}, buf_{sv, policy}
+    {
+      this->init(&buf_);
+    }
+
+    stringbuf_type* rdbuf() const { return const_cast<stringbuf_type*>(&buf_); }
+
+    const string_type& str() const { return buf_.str(); }
+    string_view_type view() const { return buf_.view(); }
+    void str(string_view_type sv) { buf_.str(sv); }
+    bool truncated() const { return buf_.truncated(); }
+
+  private:
+    stringbuf_type buf_;
+  };
+
+  template<std::size_t MaxSize>
+  using inplace_stringbuf = basic_inplace_stringbuf<char, MaxSize>;
+  template<std::size_t MaxSize>
+  using inplace_wstringbuf = basic_inplace_stringbuf<wchar_t, MaxSize>;
+  template<std::size_t MaxSize>
+  using inplace_ostream = basic_inplace_ostream<char, MaxSize>;
+  template<std::size_t MaxSize>
+  using inplace_wostream = basic_inplace_ostream<wchar_t, MaxSize>;
+}
@@ -24,11 +24,24 @@
 
 #include <array>
 #include <cassert>
+#include <charconv>
+#include <cmath>
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <istream>
 #include <iterator>
 #include <limits>
+#include <locale>
+#include <stdexcept>
 #include <string>
 #include <string_view>
+#include <type_traits>
+
+#if defined(MP_INPLACE_STRING_TELEMETRY)
+#include <mp/inplace_string_telemetry.h>
+#endif
 
 namespace mp {
 
@@ -39,6 +52,208 @@ namespace mp {
     template<size_t Size>
     using impl_size_type_helper =
         std::conditional_t<Size == 1, std::uint8_t, std::conditional_t<Size == 2, std::uint16_t, std::uint32_t>>;
+
+    // char_traits bulk operations are not constexpr before C++20 so fall back to per-character loops
+    // only during constant evaluation (or when it cannot be detected)
+    constexpr bool is_constant_evaluated() noexcept
+    {
+#if defined(__cpp_lib_is_constant_evaluated)
+      return std::is_constant_evaluated();
+#elif defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+      return __builtin_is_constant_evaluated();
+#else
+      return true;
+#endif
+#else
+      return true;
+#endif
+    }
+
+    template<typename Traits, typename CharT, typename InputIt>
+    constexpr void copy_chars(CharT* dest, InputIt first, std::size_t count)
+    {
+      if constexpr(std::is_convertible_v<InputIt, const CharT*>) {
+        if(!is_constant_evaluated()) {
+          Traits::copy(dest, first, count);
+          return;
+        }
+      }
+      for(std::size_t i = 0; i < count; ++i, ++first) Traits::assign(dest[i], *first);
+    }
+
+    template<typename Traits, typename CharT>
+    constexpr void fill_chars(CharT* dest, std::size_t count, CharT c)
+    {
+      if(!is_constant_evaluated())
+        Traits::assign(dest, count, c);
+      else
+        for(std::size_t i = 0; i < count; ++i) Traits::assign(dest[i], c);
+    }
+
+    // Strings of 'char' with MaxSize 7 or 15 occupy exactly one or two 64-bit words (the size is kept in the
+    // most significant byte of the last word on little-endian targets). Such strings are compared and hashed
+    // with size-masked integer operations instead of character loops.
+#if(defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || defined(_MSC_VER)
+    template<typename CharT, std::size_t MaxSize, typename Traits>
+    constexpr bool is_word_sized = std::is_same_v<CharT, char> && std::is_same_v<Traits, std::char_traits<char>> &&
+                                   (MaxSize == 7 || MaxSize == 15);
+#else
+    template<typename CharT, std::size_t MaxSize, typename Traits>
+    constexpr bool is_word_sized = false;
+#endif
+
+    inline std::uint64_t byteswap(std::uint64_t v) noexcept
+    {
+#if defined(__GNUC__)
+      return __builtin_bswap64(v);
+#else
+      v = ((v & 0x00FF00FF00FF00FFull) << 8) | ((v >> 8) & 0x00FF00FF00FF00FFull);
+      v = ((v & 0x0000FFFF0000FFFFull) << 16) | ((v >> 16) & 0x0000FFFF0000FFFFull);
+      return (v << 32) | (v >> 32);
+#endif
+    }
+
+    // words of the string with all the bytes starting from 'size' (including the size byte) cleared
+    template<std::size_t MaxSize>
+    struct masked_words {
+      static constexpr std::size_t count = (MaxSize + 1) / sizeof(std::uint64_t);
+      std::uint64_t words[count];
+
+      masked_words(const char* chars, std::size_t size) noexcept
+      {
+        std::memcpy(words, chars, sizeof(words));
+        for(std::size_t i = 0; i < count; ++i) {
+          const std::size_t used = size > i * 8 ? size - i * 8 : 0;
+          words[i] &= used >= 8 ? ~std::uint64_t{} : (std::uint64_t{1} << (8 * used)) - 1;
+        }
+      }
+    };
+
+    template<std::size_t MaxSize>
+    inline bool word_equal(const char* lhs, const char* rhs) noexcept
+    {
+      if(lhs[MaxSize] != rhs[MaxSize]) return false;  // different sizes
+      const std::size_t size = MaxSize - static_cast<unsigned char>(lhs[MaxSize]);
+      const masked_words<MaxSize> l{lhs, size};
+      const masked_words<MaxSize> r{rhs, size};
+      std::uint64_t diff = 0;
+      for(std::size_t i = 0; i < masked_words<MaxSize>::count; ++i) diff |= l.words[i] ^ r.words[i];
+      return diff == 0;
+    }
+
+    template<std::size_t MaxSize>
+    inline bool word_less(const char* lhs, std::size_t lhs_size, const char* rhs, std::size_t rhs_size) noexcept
+    {
+      // on little-endian targets byte-swapped words compare like memcmp() of unsigned characters
+      const masked_words<MaxSize> l{lhs, lhs_size};
+      const masked_words<MaxSize> r{rhs, rhs_size};
+      for(std::size_t i = 0; i < masked_words<MaxSize>::count; ++i)
+        if(l.words[i] != r.words[i]) return byteswap(l.words[i]) < byteswap(r.words[i]);
+      return lhs_size < rhs_size;
+    }
+
+    // writes the text, zeroed padding and the size byte with whole-word stores; 'src' may alias 'chars'
+    template<std::size_t MaxSize>
+    inline void word_assign(char* chars, const char* src, std::size_t size) noexcept
+    {
+      std::uint64_t words[(MaxSize + 1) / sizeof(std::uint64_t)] = {};
+      std::memcpy(words, src, size);
+      words[std::size(words) - 1] |= static_cast<std::uint64_t>(MaxSize - size) << 56;
+      std::memcpy(chars, words, sizeof(words));
+    }
+
+    template<std::size_t MaxSize>
+    inline std::size_t word_hash(const char* chars, std::size_t size) noexcept
+    {
+      const masked_words<MaxSize> w{chars, size};
+      std::uint64_t h = size;
+      for(std::size_t i = 0; i < masked_words<MaxSize>::count; ++i) {
+        h = (h ^ w.words[i]) * 0x9E3779B97F4A7C15ull;
+        h ^= h >> 32;
+      }
+      return static_cast<std::size_t>(h);
+    }
+
+    // numeric formatting
+    constexpr char digit_pairs[] =
+        "0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+        "5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+    constexpr std::uint64_t powers_of_10[] = {1ull,
+                                              10ull,
+                                              100ull,
+                                              1'000ull,
+                                              10'000ull,
+                                              100'000ull,
+                                              1'000'000ull,
+                                              10'000'000ull,
+                                              100'000'000ull,
+                                              1'000'000'000ull,
+                                              10'000'000'000ull,
+                                              100'000'000'000ull,
+                                              1'000'000'000'000ull,
+                                              10'000'000'000'000ull,
+                                              100'000'000'000'000ull,
+                                              1'000'000'000'000'000ull,
+                                              10'000'000'000'000'000ull,
+                                              100'000'000'000'000'000ull,
+                                              1'000'000'000'000'000'000ull};
+
+    // the widest results of append_int()/append_uint(), append_float() and append_fixed()
+    template<typename Int>
+    constexpr std::size_t max_int_chars = std::numeric_limits<Int>::digits10 + 1 + std::is_signed_v<Int>;
+    template<typename Float>
+    constexpr std::size_t max_float_chars = std::is_same_v<Float, float> ? 15 : 24;  // "-1.23456789e-38"
+    constexpr std::size_t max_fixed_decimals = 18;
+    constexpr std::size_t max_fixed_chars = 21;  // sign, 19 digits of the scaled value and decimal point
+
+    constexpr std::size_t count_digits(std::uint64_t v) noexcept
+    {
+      std::size_t n = 1;
+      while(true) {
+        if(v < 10) return n;
+        if(v < 100) return n + 1;
+        if(v < 1000) return n + 2;
+        if(v < 10000) return n + 3;
+        v /= 10000;
+        n += 4;
+      }
+    }
+
+    // writes 'count' digits of v (zero-padded) two at a time backwards ending at 'last'
+    template<typename CharT>
+    constexpr void write_digits(CharT* last, std::uint64_t v, std::size_t count) noexcept
+    {
+      for(; count >= 2; count -= 2) {
+        const auto i = static_cast<std::size_t>(v % 100) * 2;
+        v /= 100;
+        *--last = static_cast<CharT>(digit_pairs[i + 1]);
+        *--last = static_cast<CharT>(digit_pairs[i]);
+      }
+      if(count) *--last = static_cast<CharT>('0' + v % 10);
+    }
+
+    // shortest representation that round-trips; returns nullptr if it does not fit into [first, last)
+    template<typename Float>
+    inline char* format_shortest(char* first, char* last, Float value)
+    {
+#if defined(__cpp_lib_to_chars)
+      const auto result = std::to_chars(first, last, value);
+      return result.ec == std::errc{} ? result.ptr : nullptr;
+#else
+      char buffer[32];
+      int length = 0;
+      for(int precision = std::numeric_limits<Float>::digits10; precision <= std::numeric_limits<Float>::max_digits10;
+          ++precision) {
+        length = std::snprintf(buffer, sizeof(buffer), "%.*g", precision, static_cast<double>(value));
+        if(static_cast<Float>(std::strtod(buffer, nullptr)) == value) break;
+      }
+      if(length > last - first) return nullptr;
+      std::memcpy(first, buffer, static_cast<std::size_t>(length));
+      return first + length;
+#endif
+    }
   }
 
   template<typename CharT, std::size_t MaxSize, typename Traits = std::char_traits<std::decay_t<CharT>>>
@@ -149,10 +364,36 @@ namespace mp {
     {
       const auto sz = size();
       size(n);
-      if(n > sz)
-        traits_type::assign(data() + sz, n - sz, c);
+      if(n > sz) {
+        detail::fill_chars<traits_type>(data() + sz, n - sz, c);
+        record_copy(n - sz);
+      }
+      record_size();
     }
     constexpr void resize(size_type n) { resize(n, value_type{}); }
+    template<typename Operation>
+    constexpr void resize_and_overwrite(size_type n, Operation op)
+    {
+      if(n > max_size()) throw_length_error();
+      const auto old_size = size();
+      const auto new_size = static_cast<size_type>(std::move(op)(data(), n));
+      assert(new_size <= n);
+      size(new_size);
+      if(new_size > old_size) record_copy(new_size - old_size);
+      record_size();
+    }
+    constexpr pointer append_uninitialized(size_type n)
+    {
+      const auto sz = size();
+      if(n > max_size() - sz) throw_length_error();
+      return data() + sz;
+    }
+    constexpr void commit(size_type n)
+    {
+      size(size() + n);
+      record_copy(n);
+      record_size();
+    }
     constexpr void clear() { size(0); }
     constexpr bool empty() const { return size() == 0; }
 
@@ -176,54 +417,156 @@ namespace mp {
 
     // modifiers
     template<std::size_t OtherMaxSize>
-    basic_inplace_string& operator+=(const basic_inplace_string<CharT, OtherMaxSize, Traits>& str)
+    constexpr basic_inplace_string& operator+=(const basic_inplace_string<CharT, OtherMaxSize, Traits>& str)
     {
       return append(str);
     }
-    basic_inplace_string& operator+=(std::basic_string_view<CharT, Traits> sv) { return append(sv); }
-    basic_inplace_string& operator+=(const_pointer s) { return append(s); }
-    basic_inplace_string& operator+=(value_type c)
+    constexpr basic_inplace_string& operator+=(std::basic_string_view<CharT, Traits> sv) { return append(sv); }
+    constexpr basic_inplace_string& operator+=(const_pointer s) { return append(s); }
+    constexpr basic_inplace_string& operator+=(value_type c)
     {
       push_back(c);
       return *this;
     }
-    basic_inplace_string& operator+=(std::initializer_list<CharT> il) { return append(il); }
+    constexpr basic_inplace_string& operator+=(std::initializer_list<CharT> il) { return append(il); }
 
     template<std::size_t OtherMaxSize>
-    basic_inplace_string& append(const basic_inplace_string<CharT, OtherMaxSize, Traits>& str) { return append(str.data(), str.size()); }
+    constexpr basic_inplace_string& append(const basic_inplace_string<CharT, OtherMaxSize, Traits>& str) { return append(str.data(), str.size()); }
     template<std::size_t OtherMaxSize>
-    basic_inplace_string& append(const basic_inplace_string<CharT, OtherMaxSize, Traits>& str, size_type pos,
+    constexpr basic_inplace_string& append(const basic_inplace_string<CharT, OtherMaxSize, Traits>& str, size_type pos,
                                  size_type n = npos)
     {
       return append(std::basic_string_view<CharT, Traits>{str}.substr(pos, n));
     }
-    basic_inplace_string& append(std::basic_string_view<CharT, Traits> sv) { return append(sv.data(), sv.size()); }
+    constexpr basic_inplace_string& append(std::basic_string_view<CharT, Traits> sv) { return append(sv.data(), sv.size()); }
     template<class T,
              detail::Requires<std::is_convertible<const T&, std::basic_string_view<CharT, Traits>>,
                               std::negation<std::is_convertible<const T&, const CharT*>>> = true>
-    basic_inplace_string& append(const T& t, size_type pos, size_type n = npos) {
+    constexpr basic_inplace_string& append(const T& t, size_type pos, size_type n = npos) {
       return append(std::basic_string_view<CharT, Traits>{t}.substr(pos, n));
     }
-    basic_inplace_string& append(const_pointer s, size_type n)
+    constexpr basic_inplace_string& append(const_pointer s, size_type n)
     {
       const auto sz = size();
       size(sz + n);
-      traits_type::copy(data() + sz, s, n);
+      detail::copy_chars<traits_type>(data() + sz, s, n);
+      record_copy(n);
+      record_size();
       return *this;
     }
-    basic_inplace_string& append(const_pointer s) { return append(s, traits_type::length(s)); }
-    basic_inplace_string& append(size_type n, value_type c) { resize(size() + n, c); return *this; }
+    constexpr basic_inplace_string& append(const_pointer s) { return append(s, traits_type::length(s)); }
+    constexpr basic_inplace_string& append(size_type n, value_type c) { resize(size() + n, c); return *this; }
     template<class InputIterator>
-    basic_inplace_string& append(InputIterator first, InputIterator last)
+    constexpr basic_inplace_string& append(InputIterator first, InputIterator last)
     {
       const auto sz = size();
       const auto count = std::distance(first, last);
       size(sz + count);
-      traits_type::copy(data() + sz, first, count);
+      detail::copy_chars<traits_type>(data() + sz, first, count);
+      record_copy(count);
+      record_size();
+      return *this;
+    }
+    constexpr basic_inplace_string& append(std::initializer_list<CharT> il) { return append(il.begin(), il.end()); }
+    constexpr void push_back(value_type c)
+    {
+      if constexpr(detail::is_word_sized<CharT, MaxSize, Traits>) {
+        if(!detail::is_constant_evaluated()) {
+          // the character and the new terminator in one 16-bit store; for the last character the terminator
+          // lands on the size byte, which is 0 for a full string as well
+          const auto sz = size();
+          if(sz == max_size()) throw_length_error();
+          const std::uint16_t pair = static_cast<unsigned char>(c);
+          std::memcpy(chars_.data() + sz, &pair, sizeof(pair));
+          chars_.back() = static_cast<impl_size_type>(max_size() - sz - 1);
+          record_copy(1);
+          return;
+        }
+      }
+      const auto sz = size();
+      size(sz + 1);
+      traits_type::assign(chars_[sz], c);
+      record_copy(1);
+    }
+
+    // numeric formatting (digits are written directly into the string storage)
+    template<typename Int, detail::Requires<std::is_integral<Int>, std::is_signed<Int>> = true>
+    constexpr basic_inplace_string& append_int(Int value)
+    {
+      static_assert(detail::max_int_chars<Int> <= MaxSize, "MaxSize too small for the widest value of Int");
+      const bool negative = value < 0;
+      const auto magnitude = static_cast<std::uint64_t>(negative ? 0 - static_cast<std::uint64_t>(value) : value);
+      const auto digits = detail::count_digits(magnitude);
+      const auto n = digits + negative;
+      const pointer p = append_uninitialized(n);
+      if(negative) traits_type::assign(*p, CharT('-'));
+      detail::write_digits(p + n, magnitude, digits);
+      commit(n);
+      return *this;
+    }
+    template<typename UInt, detail::Requires<std::is_integral<UInt>, std::is_unsigned<UInt>,
+                                             std::negation<std::is_same<UInt, bool>>> = true>
+    constexpr basic_inplace_string& append_uint(UInt value)
+    {
+      static_assert(detail::max_int_chars<UInt> <= MaxSize, "MaxSize too small for the widest value of UInt");
+      const auto n = detail::count_digits(value);
+      detail::write_digits(append_uninitialized(n) + n, value, n);
+      commit(n);
+      return *this;
+    }
+
+    // shortest representation that reads back as the same value (like std::to_chars(first, last, value))
+    template<typename Float>
+    basic_inplace_string& append_float(Float value)
+    {
+      static_assert(std::is_same_v<Float, float> || std::is_same_v<Float, double>, "float or double expected");
+      static_assert(detail::max_float_chars<Float> <= MaxSize, "MaxSize too small for the widest value of Float");
+      if constexpr(std::is_same_v<CharT, char>) {
+        const pointer first = data() + size();
+        const pointer last = detail::format_shortest(first, data() + max_size(), value);
+        if(!last) {
+          size(size());  // digits written before the failure may have overwritten the terminator
+          throw_length_error();
+        }
+        commit(static_cast<size_type>(last - first));
+      }
+      else {
+        char buffer[detail::max_float_chars<Float>];
+        const auto n = static_cast<size_type>(detail::format_shortest(buffer, buffer + sizeof(buffer), value) - buffer);
+        const pointer p = append_uninitialized(n);
+        for(size_type i = 0; i < n; ++i) traits_type::assign(p[i], static_cast<CharT>(buffer[i]));
+        commit(n);
+      }
+      return *this;
+    }
+
+    // value rounded to 'decimals' (up to 18) fractional digits; the scaled value must fit in 63 bits
+    template<typename Float>
+    basic_inplace_string& append_fixed(Float value, int decimals)
+    {
+      static_assert(std::is_same_v<Float, float> || std::is_same_v<Float, double>, "float or double expected");
+      static_assert(detail::max_fixed_chars <= MaxSize, "MaxSize too small for the widest fixed-point value");
+      if(decimals < 0 || static_cast<std::size_t>(decimals) > detail::max_fixed_decimals)
+        throw std::out_of_range("basic_inplace_string::append_fixed: decimals out of range");
+      const auto d = static_cast<std::size_t>(decimals);
+      const double scaled = std::round(static_cast<double>(value) * static_cast<double>(detail::powers_of_10[d]));
+      if(!(std::fabs(scaled) < 9223372036854775808.0))
+        throw std::out_of_range("basic_inplace_string::append_fixed: value out of range");
+      const bool negative = scaled < 0;
+      const auto magnitude = static_cast<std::uint64_t>(negative ? -scaled : scaled);
+      const auto integral = magnitude / detail::powers_of_10[d];
+      const auto digits = detail::count_digits(integral);
+      const auto n = negative + digits + (d > 0 ? d + 1 : 0);
+      const pointer p = append_uninitialized(n);
+      if(negative) traits_type::assign(*p, CharT('-'));
+      if(d > 0) {
+        detail::write_digits(p + n, magnitude % detail::powers_of_10[d], d);
+        traits_type::assign(p[n - d - 1], CharT('.'));
+      }
+      detail::write_digits(p + negative + digits, integral, digits);
+      commit(n);
       return *this;
     }
-    basic_inplace_string& append(std::initializer_list<CharT> il) { return append(il.begin(), il.end()); }
-    void push_back(value_type c) { append(static_cast<size_type>(1), c); }
 
     template<std::size_t OtherMaxSize>
     constexpr basic_inplace_string& assign(const basic_inplace_string<CharT, OtherMaxSize, Traits>& str)
@@ -250,8 +593,19 @@ namespace mp {
     constexpr basic_inplace_string& assign(const_pointer s, size_type count) noexcept
     {
       assert(count <= MaxSize);
+      if(count > max_size()) throw_length_error();  // terminates as the function is noexcept
+      if constexpr(detail::is_word_sized<CharT, MaxSize, Traits>) {
+        if(!detail::is_constant_evaluated()) {
+          detail::word_assign<MaxSize>(chars_.data(), s, count);
+          record_copy(count);
+          record_size();
+          return *this;
+        }
+      }
       size(count);
-      traits_type::copy(data(), s, count);
+      detail::copy_chars<traits_type>(data(), s, count);
+      record_copy(count);
+      record_size();
       return *this;
     }
     constexpr basic_inplace_string& assign(const_pointer s) noexcept { return assign(s, traits_type::length(s)); };
@@ -264,14 +618,18 @@ namespace mp {
       assert(count < npos);
       assert(count <= MaxSize);
       size(count);
-      traits_type::assign(data(), count, ch);
+      detail::fill_chars<traits_type>(data(), count, ch);
+      record_copy(count);
+      record_size();
       return *this;
     }
     template<class InputIt, detail::Requires<std::negation<std::is_integral<InputIt>>> = true>
     constexpr basic_inplace_string& assign(InputIt first, InputIt last)
     {
       size(std::distance(first, last));
-      traits_type::copy(data(), first, size());
+      detail::copy_chars<traits_type>(data(), first, size());
+      record_copy(size());
+      record_size();
       return *this;
     }
     template<class InputIt, detail::Requires<std::is_integral<InputIt>> = true>
@@ -290,17 +648,54 @@ namespace mp {
     }
 
     // modifiers
-    constexpr void swap(basic_inplace_string& other) { std::swap(chars_, other.chars_); }
+    constexpr void swap(basic_inplace_string& other)
+    {
+      const auto tmp = chars_;
+      chars_ = other.chars_;
+      other.chars_ = tmp;
+    }
+
+#if defined(MP_INPLACE_STRING_TELEMETRY)
+    // statistics of this instantiation
+    static detail::inplace_string_stats& telemetry()
+    {
+      static detail::inplace_string_stats stats{sizeof(CharT), MaxSize};
+      return stats;
+    }
+#endif
 
   private:
-    std::array<value_type, MaxSize + 1> chars_;  // size is stored as max_size() - size() on the last byte
+    std::array<value_type, MaxSize + 1> chars_{};  // size is stored as max_size() - size() on the last byte
 
     constexpr void size(size_type s)
     {
-      if(s > max_size()) throw std::length_error("mp::basic_inplace_string: size() > max_size()");
+      if(s > max_size()) throw_length_error();
       chars_[s] = '\0';
       chars_.back() = static_cast<impl_size_type>(max_size() - s);
     }
+
+    [[noreturn]] static void throw_length_error()
+    {
+#if defined(MP_INPLACE_STRING_TELEMETRY)
+      telemetry().record_overflow();
+#endif
+      throw std::length_error("mp::basic_inplace_string: size() > max_size()");
+    }
+
+    static constexpr void record_copy([[maybe_unused]] size_type count)
+    {
+#if defined(MP_INPLACE_STRING_TELEMETRY)
+      if(!detail::is_constant_evaluated()) telemetry().record_copy(count);
+#endif
+    }
+
+    // called once with the final size of every completed assign, append or resize
+    constexpr void record_size() const
+    {
+#if defined(MP_INPLACE_STRING_TELEMETRY)
+      if(!detail::is_constant_evaluated()) telemetry().record_size(size());
+#endif
+    }
   };
 
   // relational operators
@@ -308,7 +703,9 @@ namespace mp {
   constexpr bool operator==(const basic_inplace_string<CharT, MaxSize, Traits>& lhs,
                             const basic_inplace_string<CharT, MaxSize, Traits>& rhs)
   {
-    return std::equal(std::begin(lhs), std::end(lhs), std::begin(rhs), std::end(rhs));
+    if constexpr(detail::is_word_sized<CharT, MaxSize, Traits>)
+      if(!detail::is_constant_evaluated()) return detail::word_equal<MaxSize>(lhs.data(), rhs.data());
+    return std::basic_string_view<CharT, Traits>{lhs} == std::basic_string_view<CharT, Traits>{rhs};
   }
 
   template<typename CharT, std::size_t MaxSize, class Traits>
@@ -322,7 +719,10 @@ namespace mp {
   constexpr bool operator<(const basic_inplace_string<CharT, MaxSize, Traits>& lhs,
                            const basic_inplace_string<CharT, MaxSize, Traits>& rhs)
   {
-    return std::lexicographical_compare(std::begin(lhs), std::end(lhs), std::begin(rhs), std::end(rhs));
+    if constexpr(detail::is_word_sized<CharT, MaxSize, Traits>)
+      if(!detail::is_constant_evaluated())
+        return detail::word_less<MaxSize>(lhs.data(), lhs.size(), rhs.data(), rhs.size());
+    return std::basic_string_view<CharT, Traits>{lhs} < std::basic_string_view<CharT, Traits>{rhs};
   }
 
   template<typename CharT, std::size_t MaxSize, class Traits>
@@ -350,13 +750,13 @@ namespace mp {
   template<typename CharT, std::size_t MaxSize, class Traits>
   constexpr bool operator==(const CharT* lhs, const basic_inplace_string<CharT, MaxSize, Traits>& rhs)
   {
-    return std::equal(lhs, lhs + Traits::length(lhs), std::begin(rhs), std::end(rhs));
+    return std::basic_string_view<CharT, Traits>{lhs} == std::basic_string_view<CharT, Traits>{rhs};
   }
 
   template<typename CharT, std::size_t MaxSize, class Traits>
   constexpr bool operator==(const basic_inplace_string<CharT, MaxSize, Traits>& lhs, const CharT* rhs)
   {
-    return std::equal(std::begin(lhs), std::end(lhs), rhs, rhs + Traits::length(rhs));
+    return std::basic_string_view<CharT, Traits>{lhs} == std::basic_string_view<CharT, Traits>{rhs};
   }
 
   template<typename CharT, std::size_t MaxSize, class Traits>
@@ -374,13 +774,13 @@ namespace mp {
   template<typename CharT, std::size_t MaxSize, class Traits>
   constexpr bool operator<(const CharT* lhs, const basic_inplace_string<CharT, MaxSize, Traits>& rhs)
   {
-    return std::lexicographical_compare(lhs, lhs + Traits::length(lhs), std::begin(rhs), std::end(rhs));
+    return std::basic_string_view<CharT, Traits>{lhs} < std::basic_string_view<CharT, Traits>{rhs};
   }
 
   template<typename CharT, std::size_t MaxSize, class Traits>
   constexpr bool operator<(const basic_inplace_string<CharT, MaxSize, Traits>& lhs, const CharT* rhs)
   {
-    return std::lexicographical_compare(std::begin(lhs), std::end(lhs), rhs, rhs + Traits::length(rhs));
+    return std::basic_string_view<CharT, Traits>{lhs} < std::basic_string_view<CharT, Traits>{rhs};
   }
 
   template<typename CharT, std::size_t MaxSize, class Traits>
@@ -419,12 +819,277 @@ namespace mp {
     return !(lhs < rhs);
   }
 
+  // concatenation
+  namespace detail {
+    // describes how an operand of a concatenation expression is stored, bounded and written
+    template<typename CharT, typename Traits, typename T>
+    struct concat_operand {
+    };
+
+    template<typename CharT, typename Traits, typename T, typename = void>
+    struct is_concat_operand : std::false_type {
+    };
+    template<typename CharT, typename Traits, typename T>
+    struct is_concat_operand<CharT, Traits, T, std::void_t<decltype(concat_operand<CharT, Traits, T>::capacity)>>
+        : std::true_type {
+    };
+
+    // character type and traits of the string-like operands
+    template<typename T>
+    struct concat_traits {
+    };
+
+    template<typename T, typename = void>
+    struct is_concat_string : std::false_type {
+    };
+    template<typename T>
+    struct is_concat_string<T, std::void_t<typename concat_traits<T>::char_type>> : std::true_type {
+    };
+
+    template<typename CharT, typename Traits, typename Lhs, typename Rhs>
+    class concat_expr {
+      using lhs_operand = concat_operand<CharT, Traits, Lhs>;
+      using rhs_operand = concat_operand<CharT, Traits, Rhs>;
+
+    public:
+      static constexpr std::size_t capacity = lhs_operand::capacity + rhs_operand::capacity;
+
+      constexpr concat_expr(const Lhs& lhs, const Rhs& rhs) : lhs_{lhs}, rhs_{rhs} {}
+
+      constexpr CharT* write(CharT* out) const { return rhs_operand::write(lhs_operand::write(out, lhs_), rhs_); }
+
+      // the whole expression is written in one pass followed by a single size update
+      template<std::size_t MaxSize, Requires<std::bool_constant<(MaxSize >= capacity)>> = true>
+      constexpr operator basic_inplace_string<CharT, MaxSize, Traits>() const
+      {
+        basic_inplace_string<CharT, MaxSize, Traits> result;
+        result.resize_and_overwrite(capacity, [this](CharT* p, std::size_t) { return write(p) - p; });
+        return result;
+      }
+
+    private:
+      typename lhs_operand::stored_type lhs_;
+      typename rhs_operand::stored_type rhs_;
+    };
+
+    template<typename CharT, std::size_t MaxSize, typename Traits>
+    struct concat_operand<CharT, Traits, basic_inplace_string<CharT, MaxSize, Traits>> {
+      using stored_type = const basic_inplace_string<CharT, MaxSize, Traits>&;
+      static constexpr std::size_t capacity = MaxSize;
+      static constexpr CharT* write(CharT* out, stored_type str)
+      {
+        copy_chars<Traits>(out, str.data(), str.size());
+        return out + str.size();
+      }
+    };
+
+    template<typename CharT, typename Traits, std::size_t N>
+    struct concat_operand<CharT, Traits, CharT[N]> {
+      using stored_type = const CharT (&)[N];
+      static constexpr std::size_t capacity = N - 1;
+      static constexpr CharT* write(CharT* out, stored_type str)
+      {
+        const auto len = Traits::length(str);
+        copy_chars<Traits>(out, str, len);
+        return out + len;
+      }
+    };
+
+    template<typename CharT, typename Traits>
+    struct concat_operand<CharT, Traits, CharT> {
+      using stored_type = CharT;
+      static constexpr std::size_t capacity = 1;
+      static constexpr CharT* write(CharT* out, stored_type c)
+      {
+        Traits::assign(*out, c);
+        return out + 1;
+      }
+    };
+
+    template<typename CharT, typename Traits, typename Lhs, typename Rhs>
+    struct concat_operand<CharT, Traits, concat_expr<CharT, Traits, Lhs, Rhs>> {
+      using stored_type = concat_expr<CharT, Traits, Lhs, Rhs>;  // holds only references and characters
+      static constexpr std::size_t capacity = stored_type::capacity;
+      static constexpr CharT* write(CharT* out, const stored_type& expr) { return expr.write(out); }
+    };
+
+    template<typename CharT, std::size_t MaxSize, typename Traits>
+    struct concat_traits<basic_inplace_string<CharT, MaxSize, Traits>> {
+      using char_type = CharT;
+      using traits_type = Traits;
+    };
+
+    template<typename CharT, typename Traits, typename Lhs, typename Rhs>
+    struct concat_traits<concat_expr<CharT, Traits, Lhs, Rhs>> {
+      using char_type = CharT;
+      using traits_type = Traits;
+    };
+  }
+
+  // Concatenation is lazy: the result is an expression which converts to a basic_inplace_string
+  // with enough capacity for the sum of the operands' capacities. Operands are referenced, not
+  // copied, so the expression should be converted before the end of the full-expression.
+  template<typename Lhs, typename Rhs, typename CharT = typename detail::concat_traits<Lhs>::char_type,
+           typename Traits = typename detail::concat_traits<Lhs>::traits_type,
+           detail::Requires<detail::is_concat_operand<CharT, Traits, Rhs>> = true>
+  constexpr detail::concat_expr<CharT, Traits, Lhs, Rhs> operator+(const Lhs& lhs, const Rhs& rhs)
+  {
+    return {lhs, rhs};
+  }
+
+  template<typename Lhs, typename Rhs, typename CharT = typename detail::concat_traits<Rhs>::char_type,
+           typename Traits = typename detail::concat_traits<Rhs>::traits_type,
+           detail::Requires<std::negation<detail::is_concat_string<Lhs>>,
+                            detail::is_concat_operand<CharT, Traits, Lhs>> = true>
+  constexpr detail::concat_expr<CharT, Traits, Lhs, Rhs> operator+(const Lhs& lhs, const Rhs& rhs)
+  {
+    return {lhs, rhs};
+  }
+
+  // deduction guides
+  template<typename CharT, std::size_t N>
+  basic_inplace_string(const CharT (&)[N]) -> basic_inplace_string<CharT, N - 1>;
+  template<typename CharT, typename Traits, typename Lhs, typename Rhs>
+  basic_inplace_string(const detail::concat_expr<CharT, Traits, Lhs, Rhs>&)
+      -> basic_inplace_string<CharT, detail::concat_expr<CharT, Traits, Lhs, Rhs>::capacity, Traits>;
+
   // input/output
+  namespace detail {
+
+    // Gives access to the buffered get area of any stream buffer. A derived class may form pointers to
+    // the protected members of basic_streambuf and those are usable with any basic_streambuf object.
+    template<typename CharT, typename Traits>
+    class get_area : std::basic_streambuf<CharT, Traits> {
+      using streambuf = std::basic_streambuf<CharT, Traits>;
+
+    public:
+      static const CharT* begin(streambuf& sb) { return (sb.*&get_area::gptr)(); }
+      static const CharT* end(streambuf& sb) { return (sb.*&get_area::egptr)(); }
+      static void advance(streambuf& sb, std::size_t n) { (sb.*&get_area::gbump)(static_cast<int>(n)); }
+    };
+
+    // Copies characters from the stream buffer to out until n characters are stored, end of stream is
+    // reached or find_stop(begin, end) finds a stop character, which is left in the stream buffer.
+    // Whole runs of the get area are scanned and copied at once.
+    template<typename CharT, typename Traits, typename FindStop>
+    std::size_t extract(std::basic_streambuf<CharT, Traits>& sb, CharT* out, std::size_t n, FindStop find_stop,
+                        std::ios_base::iostate& err)
+    {
+      std::size_t count = 0;
+      while(count < n) {
+        const auto c = sb.sgetc();
+        if(Traits::eq_int_type(c, Traits::eof())) {
+          err |= std::ios_base::eofbit;
+          break;
+        }
+        const CharT* begin = get_area<CharT, Traits>::begin(sb);
+        const CharT* end = get_area<CharT, Traits>::end(sb);
+        if(begin == end) {
+          // unbuffered stream buffer
+          const CharT ch = Traits::to_char_type(c);
+          if(find_stop(&ch, &ch + 1) != &ch + 1) break;
+          out[count++] = ch;
+          sb.sbumpc();
+          continue;
+        }
+        if(static_cast<std::size_t>(end - begin) > n - count) end = begin + (n - count);
+        const CharT* stop = find_stop(begin, end);
+        const auto length = static_cast<std::size_t>(stop - begin);
+        Traits::copy(out + count, begin, length);
+        count += length;
+        get_area<CharT, Traits>::advance(sb, length);
+        if(stop != end) break;
+      }
+      return count;
+    }
+
+    template<typename CharT, typename Traits, typename Extract>
+    std::basic_istream<CharT, Traits>& guarded_extract(std::basic_istream<CharT, Traits>& is, bool noskipws,
+                                                       Extract extract)
+    {
+      std::ios_base::iostate err = std::ios_base::goodbit;
+      const typename std::basic_istream<CharT, Traits>::sentry sentry{is, noskipws};
+      if(sentry) {
+        try {
+          extract(err);
+        }
+        catch(...) {
+          is.setstate(std::ios_base::badbit);
+          throw;
+        }
+      }
+      else
+        err |= std::ios_base::failbit;
+      if(err) is.setstate(err);
+      return is;
+    }
+
+  }  // namespace detail
+
   template<typename CharT, std::size_t MaxSize, class Traits>
   inline std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os,
                                                        const basic_inplace_string<CharT, MaxSize, Traits>& v)
   {
-    return os << v.data();
+    // honours width() and fill() like std::basic_string and writes the characters with a single sputn()
+    return os << std::basic_string_view<CharT, Traits>{v.data(), v.size()};
+  }
+
+  // Reads a whitespace-delimited word directly into the string storage. Stops after width() (if positive)
+  // or MaxSize characters leaving the rest of the word in the stream.
+  template<typename CharT, std::size_t MaxSize, class Traits>
+  std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is,
+                                                basic_inplace_string<CharT, MaxSize, Traits>& v)
+  {
+    return detail::guarded_extract(is, false, [&](std::ios_base::iostate& err) {
+      const auto width = is.width();
+      const auto limit = static_cast<std::size_t>(width);
+      const std::size_t n = width > 0 && limit < MaxSize ? limit : MaxSize;
+      const auto& ctype = std::use_facet<std::ctype<CharT>>(is.getloc());
+      const auto find_space = [&](const CharT* b, const CharT* e) {
+        return ctype.scan_is(std::ctype_base::space, b, e);
+      };
+      v.clear();
+      v.resize_and_overwrite(n, [&](CharT* p, std::size_t) {
+        return detail::extract(*is.rdbuf(), p, n, find_space, err);
+      });
+      is.width(0);
+      if(v.empty()) err |= std::ios_base::failbit;
+    });
+  }
+
+  // Reads characters directly into the string storage until delim (extracted but not stored) or end of
+  // stream. Like std::getline() sets failbit when MaxSize characters were stored without reaching delim.
+  template<typename CharT, std::size_t MaxSize, class Traits>
+  std::basic_istream<CharT, Traits>& getline(std::basic_istream<CharT, Traits>& is,
+                                             basic_inplace_string<CharT, MaxSize, Traits>& v, CharT delim)
+  {
+    return detail::guarded_extract(is, true, [&](std::ios_base::iostate& err) {
+      auto& sb = *is.rdbuf();
+      const auto find_delim = [&](const CharT* b, const CharT* e) {
+        const CharT* p = Traits::find(b, static_cast<std::size_t>(e - b), delim);
+        return p ? p : e;
+      };
+      v.clear();
+      v.resize_and_overwrite(MaxSize, [&](CharT* p, std::size_t) {
+        return detail::extract(sb, p, MaxSize, find_delim, err);
+      });
+      if(err & std::ios_base::eofbit) {
+        if(v.empty()) err |= std::ios_base::failbit;
+      }
+      else if(Traits::eq_int_type(sb.sgetc(), Traits::to_int_type(delim)))
+        sb.sbumpc();
+      else if(Traits::eq_int_type(sb.sgetc(), Traits::eof()))
+        err |= v.empty() ? std::ios_base::eofbit | std::ios_base::failbit : std::ios_base::eofbit;
+      else
+        err |= std::ios_base::failbit;
+    });
+  }
+
+  template<typename CharT, std::size_t MaxSize, class Traits>
+  std::basic_istream<CharT, Traits>& getline(std::basic_istream<CharT, Traits>& is,
+                                             basic_inplace_string<CharT, MaxSize, Traits>& v)
+  {
+    return getline(is, v, is.widen('\n'));
   }
 
   // conversions
@@ -434,13 +1099,232 @@ namespace mp {
     return {v.data(), v.size()};
   }
 
+  // parsing
+  enum class parse_status { ok, invalid, out_of_range };
+
+  template<typename T>
+  struct parse_result {
+    T value;
+    parse_status status;
+
+    constexpr explicit operator bool() const noexcept { return status == parse_status::ok; }
+  };
+
+  namespace detail {
+
+#if(defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || defined(_MSC_VER)
+    // converts 8 ASCII digits loaded from memory into a little-endian word with SWAR arithmetic
+    inline bool parse_eight_digits(std::uint64_t w, std::uint64_t& value) noexcept
+    {
+      if(((w & 0xF0F0F0F0F0F0F0F0ull) | (((w + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) !=
+         0x3333333333333333ull)
+        return false;
+      w -= 0x3030303030303030ull;
+      w = (w * 10) + (w >> 8);  // pairs of digits
+      value = (((w & 0x000000FF000000FFull) * (100 + (1000000ull << 32))) +
+               (((w >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32)))) >>
+              32;
+      return true;
+    }
+#endif
+
+    // Parses a run of 'count' decimal digits. Memory up to 'end' must be readable: the in-place storage
+    // always extends past the characters of a string so 8 digits can be loaded with a single read.
+    inline parse_status parse_digits(const char* first, std::size_t count, [[maybe_unused]] const char* end,
+                                     std::uint64_t& value) noexcept
+    {
+      while(count > 0 && *first == '0') {
+        ++first;
+        --count;
+      }
+      std::uint64_t v = 0;
+#if(defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || defined(_MSC_VER)
+      while(count > 0) {
+        // a shorter leading chunk is shifted to the top of the word and padded with '0' digits
+        const std::size_t n = count % 8 != 0 ? count % 8 : 8;
+        std::uint64_t w = 0;
+        std::memcpy(&w, first, end - first >= 8 ? 8 : static_cast<std::size_t>(end - first));
+        if(n < 8) w = (w << (8 * (8 - n))) | (0x3030303030303030ull >> (8 * n));
+        std::uint64_t chunk;
+        if(!parse_eight_digits(w, chunk)) return parse_status::invalid;
+        if(v > (std::numeric_limits<std::uint64_t>::max() - chunk) / 100'000'000) return parse_status::out_of_range;
+        v = v * 100'000'000 + chunk;
+        first += n;
+        count -= n;
+      }
+#else
+      for(; count > 0; ++first, --count) {
+        const auto digit = static_cast<unsigned>(*first - '0');
+        if(digit > 9) return parse_status::invalid;
+        if(v > (std::numeric_limits<std::uint64_t>::max() - digit) / 10) return parse_status::out_of_range;
+        v = v * 10 + digit;
+      }
+#endif
+      value = v;
+      return parse_status::ok;
+    }
+
+    inline bool parse_sign(const char*& first, std::size_t& count) noexcept
+    {
+      const bool negative = count > 0 && *first == '-';
+      if(count > 0 && (*first == '-' || *first == '+')) {
+        ++first;
+        --count;
+      }
+      return negative;
+    }
+
+    template<typename Int>
+    constexpr Int negate(std::uint64_t magnitude) noexcept
+    {
+      return magnitude == 0 ? Int{0} : static_cast<Int>(-static_cast<Int>(magnitude - 1) - 1);
+    }
+
+  }  // namespace detail
+
+  // Parsers of the whole string as a number. Digits are converted 8 at a time from words loaded from the
+  // in-place storage (which may be read past the end of the string). On failure the value is 0.
+
+  // [+]digits
+  template<typename UInt = std::uint64_t, std::size_t MaxSize, typename Traits>
+  parse_result<UInt> parse_uint(const basic_inplace_string<char, MaxSize, Traits>& str) noexcept
+  {
+    static_assert(std::is_unsigned_v<UInt> && !std::is_same_v<UInt, bool>, "unsigned integer type expected");
+    const char* first = str.data();
+    std::size_t count = str.size();
+    if(detail::parse_sign(first, count) || count == 0) return {0, parse_status::invalid};
+    std::uint64_t v;
+    const auto status = detail::parse_digits(first, count, str.data() + MaxSize + 1, v);
+    if(status != parse_status::ok) return {0, status};
+    if(v > std::numeric_limits<UInt>::max()) return {0, parse_status::out_of_range};
+    return {static_cast<UInt>(v), parse_status::ok};
+  }
+
+  // [+|-]digits
+  template<typename Int = std::int64_t, std::size_t MaxSize, typename Traits>
+  parse_result<Int> parse_int(const basic_inplace_string<char, MaxSize, Traits>& str) noexcept
+  {
+    static_assert(std::is_integral_v<Int> && std::is_signed_v<Int>, "signed integer type expected");
+    const char* first = str.data();
+    std::size_t count = str.size();
+    const bool negative = detail::parse_sign(first, count);
+    if(count == 0) return {0, parse_status::invalid};
+    std::uint64_t v;
+    const auto status = detail::parse_digits(first, count, str.data() + MaxSize + 1, v);
+    if(status != parse_status::ok) return {0, status};
+    const auto max = static_cast<std::uint64_t>(std::numeric_limits<Int>::max());
+    if(v > max + negative) return {0, parse_status::out_of_range};
+    return {negative ? detail::negate<Int>(v) : static_cast<Int>(v), parse_status::ok};
+  }
+
+  // [+|-]digits[.digits] as a fixed-point value scaled by 10^decimals (up to 18), e.g. "-101.25" with
+  // 4 decimals gives -1012500. Fractional digits past 'decimals' are accepted only if they are zeros.
+  template<std::size_t MaxSize, typename Traits>
+  parse_result<std::int64_t> parse_decimal(const basic_inplace_string<char, MaxSize, Traits>& str, int decimals)
+  {
+    if(decimals < 0 || static_cast<std::size_t>(decimals) > detail::max_fixed_decimals)
+      throw std::out_of_range("mp::parse_decimal: decimals out of range");
+    const auto d = static_cast<std::size_t>(decimals);
+    const char* const end = str.data() + MaxSize + 1;
+    const char* first = str.data();
+    std::size_t count = str.size();
+    const bool negative = detail::parse_sign(first, count);
+    const auto dot = static_cast<const char*>(std::memchr(first, '.', count));
+    const std::size_t integral_count = dot ? static_cast<std::size_t>(dot - first) : count;
+    const char* const fraction = dot ? dot + 1 : first + count;
+    const std::size_t fraction_count = dot ? count - integral_count - 1 : 0;
+    if(integral_count + fraction_count == 0) return {0, parse_status::invalid};
+
+    const std::size_t kept = fraction_count < d ? fraction_count : d;
+    for(std::size_t i = kept; i < fraction_count; ++i)
+      if(fraction[i] != '0') return {0, parse_status::invalid};
+    std::uint64_t integral, fractional;
+    auto status = detail::parse_digits(first, integral_count, end, integral);
+    if(status == parse_status::ok) status = detail::parse_digits(fraction, kept, end, fractional);
+    if(status != parse_status::ok) return {0, status};
+
+    const auto scaled_fraction = fractional * detail::powers_of_10[d - kept];
+    const auto max = static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max()) + negative;
+    if(integral > (max - scaled_fraction) / detail::powers_of_10[d]) return {0, parse_status::out_of_range};
+    const auto v = integral * detail::powers_of_10[d] + scaled_fraction;
+    return {negative ? detail::negate<std::int64_t>(v) : static_cast<std::int64_t>(v), parse_status::ok};
+  }
+
   // aliases
   template<std::size_t MaxSize>
   using inplace_string = basic_inplace_string<char, MaxSize>;
   template<std::size_t MaxSize>
   using inplace_wstring = basic_inplace_string<wchar_t, MaxSize>;
-  //  template<std::size_t MaxSize>
-  //  using inplace_u16string = basic_inplace_string<char16_t, MaxSize>;
-  //  template<std::size_t MaxSize>
-  //  using inplace_u32string = basic_inplace_string<char32_t, MaxSize>;
+#if defined(__cpp_char8_t)
+  template<std::size_t MaxSize>
+  using inplace_u8string = basic_inplace_string<char8_t, MaxSize>;
+#endif
+  template<std::size_t MaxSize>
+  using inplace_u16string = basic_inplace_string<char16_t, MaxSize>;
+  template<std::size_t MaxSize>
+  using inplace_u32string = basic_inplace_string<char32_t, MaxSize>;
+
+  namespace detail {
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+    template<typename CharT, std::size_t N>
+    struct literal_chars {
+      using char_type = CharT;
+      static constexpr std::size_t size = N - 1;
+      CharT chars[N];
+      constexpr literal_chars(const CharT (&str)[N])
+      {
+        for(std::size_t i = 0; i < N; ++i) chars[i] = str[i];
+      }
+    };
+#endif
+  }
+
+  // hashing
+  template<typename CharT, std::size_t MaxSize, class Traits>
+  inline std::size_t hash_value(const basic_inplace_string<CharT, MaxSize, Traits>& v) noexcept
+  {
+    if constexpr(detail::is_word_sized<CharT, MaxSize, Traits>)
+      return detail::word_hash<MaxSize>(v.data(), v.size());
+    else
+      return std::hash<std::basic_string_view<CharT, Traits>>{}(v);
+  }
+
+  // literals
+  inline namespace literals {
+    inline namespace inplace_string_literals {
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+      template<detail::literal_chars Str>
+      constexpr auto operator""_is()
+      {
+        using literal_type = std::remove_cv_t<decltype(Str)>;
+        return basic_inplace_string<typename literal_type::char_type, literal_type::size>{Str.chars,
+                                                                                          literal_type::size};
+      }
+#elif defined(__GNUC__)
+#pragma GCC diagnostic push
+#if defined(__clang__)
+#pragma GCC diagnostic ignored "-Wgnu-string-literal-operator-template"
+#else
+#pragma GCC diagnostic ignored "-Wpedantic"
+#endif
+      template<typename CharT, CharT... Chars>
+      constexpr basic_inplace_string<CharT, sizeof...(Chars)> operator""_is()
+      {
+        constexpr CharT chars[] = {Chars..., CharT{}};
+        return {chars, sizeof...(Chars)};
+      }
+#pragma GCC diagnostic pop
+#endif
+    }
+  }
+}
+
+namespace std {
+  template<typename CharT, std::size_t MaxSize, typename Traits>
+  struct hash<mp::basic_inplace_string<CharT, MaxSize, Traits>> {
+    std::size_t operator()(const mp::basic_inplace_string<CharT, MaxSize, Traits>& v) const noexcept
+    {
+      return mp::hash_value(v);
+    }
+  };
 }
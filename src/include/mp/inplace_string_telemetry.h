@@ -0,0 +1,136 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+// Capacity-utilization and overflow statistics of basic_inplace_string instantiations.
+//
+// Enabled by defining MP_INPLACE_STRING_TELEMETRY in every translation unit of the program (e.g. with
+// a compiler flag). Each instantiation of basic_inplace_string then registers its own statistics
+// updated with relaxed atomic increments. A size is recorded once per completed assign, append or
+// resize; default construction, clear() and single-character push_back() are not counted. Defining
+// also MP_INPLACE_STRING_TELEMETRY_DUMP_AT_EXIT prints all of them to std::cerr at program exit.
+// Updates made during constant evaluation are not recorded.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+namespace mp {
+
+  namespace detail {
+    class inplace_string_stats {
+    public:
+      static constexpr std::size_t bucket_count = 11;  // sizes in 10% steps of MaxSize, the last one for full
+
+      inplace_string_stats(std::size_t char_size, std::size_t max_size) noexcept
+          : char_size_{char_size}, max_size_{max_size}
+      {
+        auto& head = list_head();
+        next_ = head.load(std::memory_order_relaxed);
+        while(!head.compare_exchange_weak(next_, this, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+#if defined(MP_INPLACE_STRING_TELEMETRY_DUMP_AT_EXIT)
+        static const bool registered = [] { return std::atexit([] { dump(std::cerr); }) == 0; }();
+        (void)registered;
+#endif
+      }
+      inplace_string_stats(const inplace_string_stats&) = delete;
+      inplace_string_stats& operator=(const inplace_string_stats&) = delete;
+
+      void record_size(std::size_t size) noexcept
+      {
+        const std::size_t bucket = max_size_ == 0 ? bucket_count - 1 : size * 10 / max_size_;
+        histogram_[bucket].fetch_add(1, std::memory_order_relaxed);
+        if(size * 10 >= max_size_ * 9) near_overflow_.fetch_add(1, std::memory_order_relaxed);
+        auto max = max_seen_.load(std::memory_order_relaxed);
+        while(size > max && !max_seen_.compare_exchange_weak(max, size, std::memory_order_relaxed)) {
+        }
+      }
+      void record_overflow() noexcept { overflow_.fetch_add(1, std::memory_order_relaxed); }
+      void record_copy(std::size_t count) noexcept
+      {
+        bytes_copied_.fetch_add(count * char_size_, std::memory_order_relaxed);
+      }
+
+      std::size_t char_size() const noexcept { return char_size_; }
+      std::size_t max_size() const noexcept { return max_size_; }
+      std::size_t max_seen() const noexcept { return max_seen_.load(std::memory_order_relaxed); }
+      std::uint64_t histogram(std::size_t bucket) const noexcept
+      {
+        return histogram_[bucket].load(std::memory_order_relaxed);
+      }
+      std::uint64_t size_updates() const noexcept
+      {
+        std::uint64_t sum = 0;
+        for(const auto& h : histogram_) sum += h.load(std::memory_order_relaxed);
+        return sum;
+      }
+      std::uint64_t near_overflow() const noexcept { return near_overflow_.load(std::memory_order_relaxed); }
+      std::uint64_t overflow() const noexcept { return overflow_.load(std::memory_order_relaxed); }
+      std::uint64_t bytes_copied() const noexcept { return bytes_copied_.load(std::memory_order_relaxed); }
+      const inplace_string_stats* next() const noexcept { return next_; }
+
+      static const inplace_string_stats* first() noexcept { return list_head().load(std::memory_order_acquire); }
+
+      static void dump(std::ostream& os)
+      {
+        for(auto* s = first(); s != nullptr; s = s->next()) {
+          os << "basic_inplace_string<" << s->char_size() << "-byte char, " << s->max_size() << ">:"
+             << " updates=" << s->size_updates() << " max_seen=" << s->max_seen()
+             << " near_overflow=" << s->near_overflow() << " overflow=" << s->overflow()
+             << " bytes_copied=" << s->bytes_copied() << " histogram=[";
+          for(std::size_t b = 0; b < bucket_count; ++b) os << (b ? " " : "") << s->histogram(b);
+          os << "]\n";
+        }
+      }
+
+    private:
+      std::size_t char_size_;
+      std::size_t max_size_;
+      std::atomic<std::uint64_t> histogram_[bucket_count] = {};
+      std::atomic<std::uint64_t> near_overflow_{0};
+      std::atomic<std::uint64_t> overflow_{0};
+      std::atomic<std::uint64_t> bytes_copied_{0};
+      std::atomic<std::size_t> max_seen_{0};
+      inplace_string_stats* next_ = nullptr;
+
+      static std::atomic<inplace_string_stats*>& list_head() noexcept
+      {
+        static std::atomic<inplace_string_stats*> head{nullptr};
+        return head;
+      }
+    };
+  }
+
+  // prints statistics of all the basic_inplace_string instantiations used so far
+  inline void dump_inplace_string_telemetry(std::ostream& os) { detail::inplace_string_stats::dump(os); }
+
+  // statistics of one instantiation
+  template<typename InplaceString>
+  const detail::inplace_string_stats& inplace_string_telemetry()
+  {
+    return InplaceString::telemetry();
+  }
+}
@@ -0,0 +1,322 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <mp/utf8_inplace_string.h>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+// Conversions between inplace strings of different character types without going through the heap.
+//
+// The encoding follows the code unit size: 1-byte characters (char, char8_t) are UTF-8, 2-byte ones UTF-16
+// and 4-byte ones UTF-32, so wchar_t is UTF-32 or UTF-16 depending on the platform. The result capacity is
+// the worst case for the source capacity (e.g. 3 UTF-8 bytes per UTF-16 unit), limited to what the target
+// basic_inplace_string can store. Runs of ASCII are widened or narrowed 16 characters at a time with SSE2.
+
+namespace mp {
+
+  namespace detail {
+
+    template<typename CharT>
+    constexpr std::size_t max_inplace_size = std::numeric_limits<impl_size_type_helper<sizeof(CharT)>>::max();
+
+    template<typename From, typename To>
+    constexpr std::size_t max_units_per_unit = sizeof(From) <= sizeof(To)           ? 1
+                                               : sizeof(From) == 2 && sizeof(To) == 1 ? 3
+                                                                                      : sizeof(From) / sizeof(To);
+
+  }  // namespace detail
+
+  template<typename From, typename To, std::size_t N>
+  constexpr std::size_t transcoded_capacity =
+      N * detail::max_units_per_unit<From, To> < detail::max_inplace_size<To> ? N * detail::max_units_per_unit<From, To>
+                                                                            : detail::max_inplace_size<To>;
+
+  namespace detail {
+
+    // decodes one code point and advances 'i'; returns false for malformed input
+    template<typename CharT>
+    constexpr bool decode_code_point(const CharT* in, std::size_t n, std::size_t& i, char32_t& cp) noexcept
+    {
+      if constexpr(sizeof(CharT) == 1) {
+        const unsigned c = static_cast<unsigned char>(in[i]);
+        if(c < 0x80) {
+          cp = c;
+          ++i;
+          return true;
+        }
+        std::size_t length;
+        unsigned lo = 0x80, hi = 0xBF;
+        if(c >= 0xC2 && c <= 0xDF) {
+          length = 2;
+          cp = c & 0x1F;
+        }
+        else if(c >= 0xE0 && c <= 0xEF) {
+          length = 3;
+          cp = c & 0x0F;
+          if(c == 0xE0) lo = 0xA0;
+          if(c == 0xED) hi = 0x9F;
+        }
+        else if(c >= 0xF0 && c <= 0xF4) {
+          length = 4;
+          cp = c & 0x07;
+          if(c == 0xF0) lo = 0x90;
+          if(c == 0xF4) hi = 0x8F;
+        }
+        else
+          return false;
+        if(n - i < length) return false;
+        for(std::size_t k = 1; k < length; ++k) {
+          const unsigned cc = static_cast<unsigned char>(in[i + k]);
+          if(cc < (k == 1 ? lo : 0x80) || cc > (k == 1 ? hi : 0xBF)) return false;
+          cp = cp << 6 | (cc & 0x3F);
+        }
+        i += length;
+        return true;
+      }
+      else if constexpr(sizeof(CharT) == 2) {
+        const char32_t c = static_cast<char16_t>(in[i]);
+        if(c < 0xD800 || c > 0xDFFF) {
+          cp = c;
+          ++i;
+          return true;
+        }
+        if(c > 0xDBFF || n - i < 2) return false;
+        const char32_t low = static_cast<char16_t>(in[i + 1]);
+        if(low < 0xDC00 || low > 0xDFFF) return false;
+        cp = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+        i += 2;
+        return true;
+      }
+      else {
+        cp = static_cast<char32_t>(in[i]);
+        ++i;
+        return cp < 0xD800 || (cp > 0xDFFF && cp <= 0x10FFFF);
+      }
+    }
+
+    // encodes a valid code point; returns 0 if it does not fit in 'room' code units
+    template<typename CharT>
+    constexpr std::size_t encode_code_point(char32_t cp, CharT* out, std::size_t room) noexcept
+    {
+      if constexpr(sizeof(CharT) == 1) {
+        const std::size_t length = cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+        return length <= room ? encode_utf8(cp, out) : 0;
+      }
+      else if constexpr(sizeof(CharT) == 2) {
+        if(cp < 0x10000) {
+          if(room < 1) return 0;
+          out[0] = static_cast<CharT>(cp);
+          return 1;
+        }
+        if(room < 2) return 0;
+        out[0] = static_cast<CharT>(0xD800 + ((cp - 0x10000) >> 10));
+        out[1] = static_cast<CharT>(0xDC00 + ((cp - 0x10000) & 0x3FF));
+        return 2;
+      }
+      else {
+        if(room < 1) return 0;
+        out[0] = static_cast<CharT>(cp);
+        return 1;
+      }
+    }
+
+#if defined(__SSE2__) || defined(_M_X64)
+    template<typename CharT>
+    inline __m128i load_units(const CharT* p) noexcept
+    {
+      return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+    template<typename CharT>
+    inline void store_units(CharT* p, __m128i v) noexcept
+    {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+    }
+
+    // converts 16 code units per step while they are all ASCII (or, between UTF-16 and UTF-32, all below
+    // the surrogate range) and advances 'i' and 'o' past them
+    template<typename From, typename To>
+    inline void transcode_simple_runs(const From* in, std::size_t n, std::size_t& i, To* out, std::size_t room,
+                                      std::size_t& o) noexcept
+    {
+      const __m128i zero = _mm_setzero_si128();
+      for(; n - i >= 16 && room - o >= 16; i += 16, o += 16) {
+        const From* const src = in + i;
+        To* const dst = out + o;
+        if constexpr(sizeof(From) == 1) {
+          const __m128i v = load_units(src);
+          if(_mm_movemask_epi8(v) != 0) return;
+          if constexpr(sizeof(To) == 1)
+            store_units(dst, v);
+          else if constexpr(sizeof(To) == 2) {
+            store_units(dst, _mm_unpacklo_epi8(v, zero));
+            store_units(dst + 8, _mm_unpackhi_epi8(v, zero));
+          }
+          else {
+            const __m128i lo = _mm_unpacklo_epi8(v, zero);
+            const __m128i hi = _mm_unpackhi_epi8(v, zero);
+            store_units(dst, _mm_unpacklo_epi16(lo, zero));
+            store_units(dst + 4, _mm_unpackhi_epi16(lo, zero));
+            store_units(dst + 8, _mm_unpacklo_epi16(hi, zero));
+            store_units(dst + 12, _mm_unpackhi_epi16(hi, zero));
+          }
+        }
+        else if constexpr(sizeof(From) == 2) {
+          const __m128i a = load_units(src);
+          const __m128i b = load_units(src + 8);
+          if constexpr(sizeof(To) == 1) {
+            const __m128i high = _mm_and_si128(_mm_or_si128(a, b), _mm_set1_epi16(static_cast<short>(0xFF80)));
+            if(_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) != 0xFFFF) return;
+            store_units(dst, _mm_packus_epi16(a, b));
+          }
+          else {
+            const __m128i mask = _mm_set1_epi16(static_cast<short>(0xF800));
+            const __m128i surrogate = _mm_set1_epi16(static_cast<short>(0xD800));
+            const __m128i bad = _mm_or_si128(_mm_cmpeq_epi16(_mm_and_si128(a, mask), surrogate),
+                                             _mm_cmpeq_epi16(_mm_and_si128(b, mask), surrogate));
+            if(_mm_movemask_epi8(bad) != 0) return;
+            if constexpr(sizeof(To) == 2) {
+              store_units(dst, a);
+              store_units(dst + 8, b);
+            }
+            else {
+              store_units(dst, _mm_unpacklo_epi16(a, zero));
+              store_units(dst + 4, _mm_unpackhi_epi16(a, zero));
+              store_units(dst + 8, _mm_unpacklo_epi16(b, zero));
+              store_units(dst + 12, _mm_unpackhi_epi16(b, zero));
+            }
+          }
+        }
+        else {
+          const __m128i a = load_units(src);
+          const __m128i b = load_units(src + 4);
+          const __m128i c = load_units(src + 8);
+          const __m128i d = load_units(src + 12);
+          const __m128i all = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+          if constexpr(sizeof(To) == 1) {
+            const __m128i high = _mm_and_si128(all, _mm_set1_epi32(static_cast<int>(0xFFFFFF80)));
+            if(_mm_movemask_epi8(_mm_cmpeq_epi32(high, zero)) != 0xFFFF) return;
+            store_units(dst, _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+          }
+          else {
+            // below U+D800, i.e. (v >> 11) < 27 for every unit
+            const __m128i limit = _mm_set1_epi32(0xD800 >> 11);
+            const auto below = [&](__m128i v) { return _mm_cmplt_epi32(_mm_srli_epi32(v, 11), limit); };
+            const __m128i ok = _mm_and_si128(_mm_and_si128(below(a), below(b)), _mm_and_si128(below(c), below(d)));
+            if(_mm_movemask_epi8(ok) != 0xFFFF) return;
+            if constexpr(sizeof(To) == 2) {
+              // packs_epi32 saturates signed values, so move the range to [-0x8000, 0x5800) and back
+              const __m128i bias32 = _mm_set1_epi32(0x8000);
+              const __m128i bias16 = _mm_set1_epi16(static_cast<short>(0x8000));
+              const auto pack = [&](__m128i x, __m128i y) {
+                return _mm_add_epi16(_mm_packs_epi32(_mm_sub_epi32(x, bias32), _mm_sub_epi32(y, bias32)), bias16);
+              };
+              store_units(dst, pack(a, b));
+              store_units(dst + 8, pack(c, d));
+            }
+            else {
+              store_units(dst, a);
+              store_units(dst + 4, b);
+              store_units(dst + 8, c);
+              store_units(dst + 12, d);
+            }
+          }
+        }
+      }
+    }
+#endif
+
+    // writes at most 'room' code units and reports how many through 'written'
+    template<typename From, typename To>
+    parse_status transcode(const From* in, std::size_t n, To* out, std::size_t room, std::size_t& written) noexcept
+    {
+      std::size_t i = 0, o = 0;
+      while(i < n) {
+#if defined(__SSE2__) || defined(_M_X64)
+        transcode_simple_runs(in, n, i, out, room, o);
+        if(i == n) break;
+#endif
+        char32_t cp;
+        if(!decode_code_point(in, n, i, cp)) return parse_status::invalid;
+        const auto units = encode_code_point(cp, out + o, room - o);
+        if(units == 0) return parse_status::out_of_range;
+        o += units;
+      }
+      written = o;
+      return parse_status::ok;
+    }
+
+  }  // namespace detail
+
+  // appends 'str' converted to the encoding of 'out'; 'out' is left unchanged on failure
+  template<typename To, std::size_t MaxSize, typename ToTraits, typename From, typename FromTraits>
+  parse_status transcode_append(basic_inplace_string<To, MaxSize, ToTraits>& out,
+                                std::basic_string_view<From, FromTraits> str) noexcept
+  {
+    auto status = parse_status::ok;
+    out.resize_and_overwrite(out.max_size(), [&](To* p, std::size_t n) {
+      const auto old_size = out.size();
+      std::size_t written = 0;
+      status = detail::transcode(str.data(), str.size(), p + old_size, n - old_size, written);
+      return status == parse_status::ok ? old_size + written : old_size;
+    });
+    return status;
+  }
+
+  // returns parse_status::invalid for malformed input and parse_status::out_of_range when the result does not
+  // fit in the capacity limit of the target character type
+  template<typename To, typename From, std::size_t N, typename Traits>
+  parse_result<basic_inplace_string<To, transcoded_capacity<From, To, N>>> transcode(
+      const basic_inplace_string<From, N, Traits>& str) noexcept
+  {
+    basic_inplace_string<To, transcoded_capacity<From, To, N>> result;
+    const auto status = transcode_append(result, std::basic_string_view<From, Traits>{str});
+    return {result, status};
+  }
+
+  template<typename From, std::size_t N, typename Traits>
+  auto to_utf8(const basic_inplace_string<From, N, Traits>& str) noexcept
+  {
+    return transcode<char>(str);
+  }
+  template<typename From, std::size_t N, typename Traits>
+  auto to_utf16(const basic_inplace_string<From, N, Traits>& str) noexcept
+  {
+    return transcode<char16_t>(str);
+  }
+  template<typename From, std::size_t N, typename Traits>
+  auto to_utf32(const basic_inplace_string<From, N, Traits>& str) noexcept
+  {
+    return transcode<char32_t>(str);
+  }
+  template<typename From, std::size_t N, typename Traits>
+  auto to_wide(const basic_inplace_string<From, N, Traits>& str) noexcept
+  {
+    return transcode<wchar_t>(str);
+  }
+
+}
@@ -0,0 +1,247 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <mp/inplace_string.h>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <string_view>
+
+namespace mp {
+
+  // alphabets for packed_inplace_string (every alphabet lists its characters once, in any order)
+  struct symbol_alphabet {
+    static constexpr std::string_view chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789._-";  // 6 bits per character
+  };
+  struct upper_alphabet {
+    static constexpr std::string_view chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZ._-";  // 5 bits per character
+  };
+
+  namespace detail {
+    template<typename Alphabet>
+    struct alphabet_codec {
+      // code 0 marks unused positions; codes follow the character order so that packed words compare
+      // like the text they represent
+      static constexpr std::size_t size = Alphabet::chars.size();
+      static_assert(size > 0 && size < 256, "alphabet must have between 1 and 255 characters");
+
+      static constexpr std::size_t bits = [] {
+        std::size_t b = 1;
+        while((std::size_t{1} << b) < size + 1) ++b;
+        return b;
+      }();
+
+      static constexpr std::array<char, size + 1> decode_table = [] {
+        std::array<char, size + 1> table{};
+        for(std::size_t i = 0; i < size; ++i) table[i + 1] = Alphabet::chars[i];
+        // insertion sort by unsigned character value
+        for(std::size_t i = 2; i <= size; ++i)
+          for(std::size_t j = i; j > 1 && static_cast<unsigned char>(table[j - 1]) > static_cast<unsigned char>(table[j]);
+              --j) {
+            const char tmp = table[j];
+            table[j] = table[j - 1];
+            table[j - 1] = tmp;
+          }
+        return table;
+      }();
+
+      static constexpr std::array<std::uint8_t, 256> encode_table = [] {
+        std::array<std::uint8_t, 256> table{};
+        for(std::size_t code = 1; code <= size; ++code) {
+          auto& entry = table[static_cast<unsigned char>(decode_table[code])];
+          if(entry != 0) throw std::logic_error("mp::packed_inplace_string: duplicated alphabet character");
+          entry = static_cast<std::uint8_t>(code);
+        }
+        return table;
+      }();
+    };
+  }
+
+  // Fixed-capacity string of characters from a restricted alphabet packed at ceil(log2(alphabet size + 1))
+  // bits each into 64-bit words (e.g. 10 characters of [A-Z0-9._-] or 12 characters of [A-Z._-] per word).
+  //
+  // Characters are stored from the most significant bits of the first word and unused positions are
+  // zero, so equality, ordering and hashing operate directly on the packed words and no size needs to
+  // be stored. unpack() decodes the text to a basic_inplace_string when the characters are needed.
+  template<std::size_t MaxSize, typename Alphabet = symbol_alphabet>
+  class packed_inplace_string {
+    static_assert(MaxSize > 0, "MaxSize must be at least 1");
+    using codec = detail::alphabet_codec<Alphabet>;
+
+  public:
+    using word_type = std::uint64_t;
+    using value_type = char;
+    using size_type = std::size_t;
+    using unpacked_type = basic_inplace_string<char, MaxSize>;
+
+    static constexpr size_type bits_per_char = codec::bits;
+    static constexpr size_type chars_per_word = 64 / codec::bits;
+    static constexpr size_type word_count = (MaxSize + chars_per_word - 1) / chars_per_word;
+
+    constexpr packed_inplace_string() noexcept = default;
+    constexpr explicit packed_inplace_string(std::string_view sv) { assign(sv); }
+    constexpr explicit packed_inplace_string(const char* s) : packed_inplace_string{std::string_view{s}} {}
+
+    constexpr packed_inplace_string& assign(std::string_view sv)
+    {
+      if(sv.size() > MaxSize) throw std::length_error("mp::packed_inplace_string: size() > max_size()");
+      std::array<word_type, word_count> words{};
+      for(size_type i = 0; i < sv.size(); ++i) {
+        const auto code = encode(sv[i]);
+        if(code == 0) throw std::invalid_argument("mp::packed_inplace_string: character not in the alphabet");
+        words[i / chars_per_word] |= word_type{code} << shift(i);
+      }
+      words_ = words;
+      return *this;
+    }
+    constexpr packed_inplace_string& operator=(std::string_view sv) { return assign(sv); }
+
+    static constexpr bool contains(char c) noexcept { return encode(c) != 0; }
+
+    constexpr size_type size() const noexcept
+    {
+      size_type sz = 0;
+      for(size_type w = 0; w < word_count; ++w) {
+        if(words_[w] == 0) break;
+        for(size_type i = 0; i < chars_per_word && code_at(w * chars_per_word + i) != 0; ++i) ++sz;
+        if(sz % chars_per_word != 0) break;
+      }
+      return sz;
+    }
+    constexpr size_type length() const noexcept { return size(); }
+    static constexpr size_type max_size() noexcept { return MaxSize; }
+    constexpr bool empty() const noexcept { return words_[0] == 0; }
+
+    constexpr char operator[](size_type pos) const noexcept
+    {
+      assert(pos < MaxSize);
+      return codec::decode_table[code_at(pos)];
+    }
+
+    // decodes the whole string
+    constexpr unpacked_type unpack() const
+    {
+      unpacked_type result;
+      result.resize_and_overwrite(MaxSize, [this](char* p, size_type n) {
+        size_type i = 0;
+        for(; i < n && code_at(i) != 0; ++i) p[i] = codec::decode_table[code_at(i)];
+        return i;
+      });
+      return result;
+    }
+    constexpr operator unpacked_type() const { return unpack(); }
+
+    constexpr const std::array<word_type, word_count>& words() const noexcept { return words_; }
+
+  private:
+    std::array<word_type, word_count> words_{};
+
+    static constexpr std::size_t encode(char c) noexcept { return codec::encode_table[static_cast<unsigned char>(c)]; }
+    static constexpr unsigned shift(size_type pos) noexcept
+    {
+      return static_cast<unsigned>(64 - codec::bits * (pos % chars_per_word + 1));
+    }
+    constexpr std::size_t code_at(size_type pos) const noexcept
+    {
+      return static_cast<std::size_t>((words_[pos / chars_per_word] >> shift(pos)) &
+                                      ((word_type{1} << codec::bits) - 1));
+    }
+  };
+
+  // relational operators
+  template<std::size_t MaxSize, typename Alphabet>
+  constexpr bool operator==(const packed_inplace_string<MaxSize, Alphabet>& lhs,
+                            const packed_inplace_string<MaxSize, Alphabet>& rhs)
+  {
+    return lhs.words() == rhs.words();
+  }
+
+  template<std::size_t MaxSize, typename Alphabet>
+  constexpr bool operator!=(const packed_inplace_string<MaxSize, Alphabet>& lhs,
+                            const packed_inplace_string<MaxSize, Alphabet>& rhs)
+  {
+    return !(lhs == rhs);
+  }
+
+  template<std::size_t MaxSize, typename Alphabet>
+  constexpr bool operator<(const packed_inplace_string<MaxSize, Alphabet>& lhs,
+                           const packed_inplace_string<MaxSize, Alphabet>& rhs)
+  {
+    for(std::size_t i = 0; i < lhs.word_count; ++i)
+      if(lhs.words()[i] != rhs.words()[i]) return lhs.words()[i] < rhs.words()[i];
+    return false;
+  }
+
+  template<std::size_t MaxSize, typename Alphabet>
+  constexpr bool operator<=(const packed_inplace_string<MaxSize, Alphabet>& lhs,
+                            const packed_inplace_string<MaxSize, Alphabet>& rhs)
+  {
+    return !(rhs < lhs);
+  }
+
+  template<std::size_t MaxSize, typename Alphabet>
+  constexpr bool operator>(const packed_inplace_string<MaxSize, Alphabet>& lhs,
+                           const packed_inplace_string<MaxSize, Alphabet>& rhs)
+  {
+    return rhs < lhs;
+  }
+
+  template<std::size_t MaxSize, typename Alphabet>
+  constexpr bool operator>=(const packed_inplace_string<MaxSize, Alphabet>& lhs,
+                            const packed_inplace_string<MaxSize, Alphabet>& rhs)
+  {
+    return !(lhs < rhs);
+  }
+
+  // hashing
+  template<std::size_t MaxSize, typename Alphabet>
+  inline std::size_t hash_value(const packed_inplace_string<MaxSize, Alphabet>& v) noexcept
+  {
+    std::uint64_t h = 0;
+    for(const auto w : v.words()) {
+      h = (h ^ w) * 0x9E3779B97F4A7C15ull;
+      h ^= h >> 32;
+    }
+    return static_cast<std::size_t>(h);
+  }
+
+  // input/output
+  template<std::size_t MaxSize, typename Alphabet>
+  inline std::ostream& operator<<(std::ostream& os, const packed_inplace_string<MaxSize, Alphabet>& v)
+  {
+    return os << v.unpack();
+  }
+}
+
+namespace std {
+  template<std::size_t MaxSize, typename Alphabet>
+  struct hash<mp::packed_inplace_string<MaxSize, Alphabet>> {
+    std::size_t operator()(const mp::packed_inplace_string<MaxSize, Alphabet>& v) const noexcept
+    {
+      return mp::hash_value(v);
+    }
+  };
+}
@@ -0,0 +1,194 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <mp/inplace_string.h>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+
+namespace mp {
+
+  namespace detail {
+    constexpr std::size_t perfect_hash_table_size(std::size_t key_count)
+    {
+      std::size_t size = 1;
+      while(size < 2 * key_count) size *= 2;
+      return size;
+    }
+
+    // hashes the string in 8-byte words; the number of words is bounded by the longest key
+    template<typename CharT>
+    constexpr std::uint64_t perfect_hash(const CharT* str, std::size_t size, std::uint64_t seed)
+    {
+      constexpr std::uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+      std::uint64_t h = seed ^ (size * multiplier);
+      for(std::size_t i = 0; i < size; i += 8) {
+        std::uint64_t word = 0;
+        const std::size_t end = size - i < 8 ? size - i : 8;
+        for(std::size_t j = 0; j < end; ++j)
+          word |= static_cast<std::uint64_t>(static_cast<std::make_unsigned_t<CharT>>(str[i + j])) << (8 * j);
+        h = (h ^ word) * multiplier;
+        h ^= h >> 32;
+      }
+      h *= 0xFF51AFD7ED558CCDull;
+      return h ^ (h >> 29);
+    }
+  }
+
+  // Maps a runtime string to the index of one of the compile-time known keys (or npos) with a single
+  // bounded hash computation, one table lookup and one verification compare.
+  //
+  // The table is built with a "hash and displace" scheme: keys are grouped in buckets and every bucket
+  // gets a displacement that moves all of its keys to free slots.
+  template<typename CharT, std::size_t KeyCount, std::size_t MaxKeySize,
+           typename Traits = std::char_traits<std::decay_t<CharT>>>
+  class basic_perfect_hash_switch {
+    static_assert(KeyCount > 0, "at least one key is required");
+    static_assert(KeyCount < std::numeric_limits<std::uint16_t>::max(), "too many keys");
+
+    using slot_type = std::conditional_t<(KeyCount < std::numeric_limits<std::uint8_t>::max()), std::uint8_t,
+                                         std::uint16_t>;
+    static constexpr std::size_t table_size = detail::perfect_hash_table_size(KeyCount);
+    static constexpr std::size_t bucket_count = (KeyCount + 1) / 2;
+
+  public:
+    using key_type = basic_inplace_string<CharT, MaxKeySize, Traits>;
+    using size_type = std::size_t;
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+    constexpr explicit basic_perfect_hash_switch(const std::array<key_type, KeyCount>& keys) : keys_{keys}
+    {
+      for(size_type i = 0; i < KeyCount; ++i)
+        for(size_type j = i + 1; j < KeyCount; ++j)
+          if(keys_[i] == keys_[j]) throw std::invalid_argument("mp::basic_perfect_hash_switch: duplicated key");
+
+      for(std::uint64_t seed = 0; seed < 64; ++seed) {
+        seed_ = seed * 0x9E3779B97F4A7C15ull;
+        if(build()) return;
+      }
+      throw std::logic_error("mp::basic_perfect_hash_switch: failed to find a perfect hash");
+    }
+
+    constexpr size_type size() const noexcept { return KeyCount; }
+    constexpr const key_type& operator[](size_type index) const { return keys_[index]; }
+
+    // returns the index of the key equal to 'str' or npos
+    constexpr size_type find(std::basic_string_view<CharT, Traits> str) const noexcept
+    {
+      if(str.size() > MaxKeySize) return npos;
+      const auto index = slots_[slot(detail::perfect_hash(str.data(), str.size(), seed_))];
+      return index != KeyCount && std::basic_string_view<CharT, Traits>{keys_[index]} == str ? index : npos;
+    }
+    template<std::size_t MaxSize>
+    constexpr size_type find(const basic_inplace_string<CharT, MaxSize, Traits>& str) const noexcept
+    {
+      return find(std::basic_string_view<CharT, Traits>{str});
+    }
+
+    // maps the string to an enumerator with the value of key's index or returns 'not_found'
+    template<typename Enum, typename Str>
+    constexpr Enum find(const Str& str, Enum not_found) const noexcept
+    {
+      const auto index = find(str);
+      return index == npos ? not_found : static_cast<Enum>(index);
+    }
+
+  private:
+    std::array<key_type, KeyCount> keys_{};
+    std::array<slot_type, table_size> slots_{};
+    std::array<std::uint16_t, bucket_count> displacements_{};
+    std::uint64_t seed_ = 0;
+
+    static constexpr size_type bucket(std::uint64_t h) { return static_cast<size_type>((h >> 32) % bucket_count); }
+    constexpr size_type slot(std::uint64_t h) const
+    {
+      const auto d = displacements_[bucket(h)];
+      return static_cast<size_type>((h + d * ((h >> 32) | 1)) & (table_size - 1));
+    }
+
+    constexpr bool build()
+    {
+      std::array<std::uint64_t, KeyCount> hashes{};
+      std::array<size_type, bucket_count> bucket_sizes{};
+      size_type max_bucket_size = 0;
+      for(size_type i = 0; i < KeyCount; ++i) {
+        hashes[i] = detail::perfect_hash(keys_[i].data(), keys_[i].size(), seed_);
+        const auto s = ++bucket_sizes[bucket(hashes[i])];
+        if(s > max_bucket_size) max_bucket_size = s;
+      }
+      for(auto& s : slots_) s = static_cast<slot_type>(KeyCount);
+      for(auto& d : displacements_) d = 0;
+
+      // place the most populated buckets first
+      for(size_type s = max_bucket_size; s > 0; --s)
+        for(size_type b = 0; b < bucket_count; ++b)
+          if(bucket_sizes[b] == s && !place_bucket(b, hashes)) return false;
+      return true;
+    }
+
+    constexpr bool place_bucket(size_type b, const std::array<std::uint64_t, KeyCount>& hashes)
+    {
+      for(std::uint32_t d = 0; d <= std::numeric_limits<std::uint16_t>::max(); ++d) {
+        displacements_[b] = static_cast<std::uint16_t>(d);
+        bool ok = true;
+        for(size_type i = 0; ok && i < KeyCount; ++i) {
+          if(bucket(hashes[i]) != b) continue;
+          const auto si = slot(hashes[i]);
+          if(slots_[si] != KeyCount) ok = false;
+          for(size_type j = 0; ok && j < i; ++j)
+            if(bucket(hashes[j]) == b && slot(hashes[j]) == si) ok = false;
+        }
+        if(ok) {
+          for(size_type i = 0; i < KeyCount; ++i)
+            if(bucket(hashes[i]) == b) slots_[slot(hashes[i])] = static_cast<slot_type>(i);
+          return true;
+        }
+      }
+      return false;
+    }
+  };
+
+  namespace detail {
+    template<std::size_t First, std::size_t... Rest>
+    constexpr std::size_t max_of()
+    {
+      std::size_t result = First;
+      ((result = Rest > result ? Rest : result), ...);
+      return result;
+    }
+  }
+
+  template<typename CharT, std::size_t... N>
+  constexpr auto make_perfect_hash_switch(const CharT (&... keys)[N])
+  {
+    using switch_type = basic_perfect_hash_switch<CharT, sizeof...(N), detail::max_of<N...>() - 1>;
+    return switch_type{{typename switch_type::key_type{keys, N - 1}...}};
+  }
+
+  // aliases
+  template<std::size_t KeyCount, std::size_t MaxKeySize>
+  using perfect_hash_switch = basic_perfect_hash_switch<char, KeyCount, MaxKeySize>;
+}
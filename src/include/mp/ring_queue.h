@@ -0,0 +1,231 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace mp {
+
+  namespace detail {
+    constexpr std::size_t cache_line_size = 64;
+
+    template<typename T, typename... Args>
+    auto assign_slot(T& slot, Args&&... args) -> decltype(slot.assign(std::forward<Args>(args)...), void())
+    {
+      slot.assign(std::forward<Args>(args)...);
+    }
+    template<typename T, typename Arg>
+    auto assign_slot(T& slot, Arg&& arg) -> std::enable_if_t<std::is_same_v<std::decay_t<Arg>, T>>
+    {
+      slot = std::forward<Arg>(arg);
+    }
+  }
+
+  // Bounded lock-free queue for exactly one producer and one consumer thread.
+  //
+  // Elements are never moved in or out of the queue: producers write a message directly into a ring
+  // slot (e.g. with basic_inplace_string::assign()/append()) and consumers read it in place before the
+  // slot is released. Each side caches the other side's index to avoid touching its cache line on
+  // every operation.
+  template<typename T, std::size_t Capacity>
+  class spsc_ring_queue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
+    static_assert(std::is_default_constructible_v<T>, "T must be default constructible");
+
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    static constexpr size_type capacity() noexcept { return Capacity; }
+
+    // calls 'op(T&)' on a free slot and publishes it; returns false if the queue is full
+    template<typename Operation>
+    bool try_write(Operation op)
+    {
+      const auto tail = tail_.load(std::memory_order_relaxed);
+      if(tail - head_cache_ == Capacity) {
+        head_cache_ = head_.load(std::memory_order_acquire);
+        if(tail - head_cache_ == Capacity) return false;
+      }
+      op(slots_[tail & (Capacity - 1)]);
+      tail_.store(tail + 1, std::memory_order_release);
+      return true;
+    }
+    // assigns the arguments straight into a free slot (i.e. slot.assign(args...))
+    template<typename... Args>
+    bool try_emplace(Args&&... args)
+    {
+      return try_write([&](T& slot) { detail::assign_slot(slot, std::forward<Args>(args)...); });
+    }
+
+    // calls 'op(const T&)' on the oldest element and releases its slot; returns false if the queue is empty
+    template<typename Operation>
+    bool try_read(Operation op)
+    {
+      const auto head = head_.load(std::memory_order_relaxed);
+      if(head == tail_cache_) {
+        tail_cache_ = tail_.load(std::memory_order_acquire);
+        if(head == tail_cache_) return false;
+      }
+      op(static_cast<const T&>(slots_[head & (Capacity - 1)]));
+      head_.store(head + 1, std::memory_order_release);
+      return true;
+    }
+    bool try_pop(T& value)
+    {
+      return try_read([&](const T& slot) { value = slot; });
+    }
+
+    bool empty() const noexcept
+    {
+      return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+  private:
+    alignas(detail::cache_line_size) std::atomic<size_type> tail_{0};
+    size_type head_cache_ = 0;  // producer's view of head_
+    alignas(detail::cache_line_size) std::atomic<size_type> head_{0};
+    size_type tail_cache_ = 0;  // consumer's view of tail_
+    alignas(detail::cache_line_size) std::array<T, Capacity> slots_{};
+  };
+
+  // Bounded lock-free queue for any number of producer and consumer threads (D. Vyukov's algorithm).
+  //
+  // Every slot carries a sequence number that tells whether it is ready to be written or read in the
+  // current lap, so producers and consumers only contend on the index they advance. As in
+  // spsc_ring_queue elements are written and read in place.
+  //
+  // A slot claimed by try_write() or try_read() is always handed on, even if the operation throws:
+  // a failed write is published as an empty slot that consumers skip, and a failed read still
+  // releases the element.
+  template<typename T, std::size_t Capacity>
+  class mpmc_ring_queue {
+    static_assert(Capacity > 1 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2 bigger than 1");
+    static_assert(std::is_default_constructible_v<T>, "T must be default constructible");
+
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    mpmc_ring_queue() noexcept
+    {
+      for(size_type i = 0; i < Capacity; ++i) slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    mpmc_ring_queue(const mpmc_ring_queue&) = delete;
+    mpmc_ring_queue& operator=(const mpmc_ring_queue&) = delete;
+
+    static constexpr size_type capacity() noexcept { return Capacity; }
+
+    // calls 'op(T&)' on a free slot and publishes it; returns false if the queue is full
+    template<typename Operation>
+    bool try_write(Operation op)
+    {
+      auto pos = write_pos_.load(std::memory_order_relaxed);
+      for(;;) {
+        auto& slot = slots_[pos & (Capacity - 1)];
+        const auto seq = slot.sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+        if(diff == 0) {
+          if(write_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+            try {
+              op(slot.value);
+            }
+            catch(...) {
+              slot.valid = false;
+              slot.sequence.store(pos + 1, std::memory_order_release);
+              throw;
+            }
+            slot.valid = true;
+            slot.sequence.store(pos + 1, std::memory_order_release);
+            return true;
+          }
+        }
+        else if(diff < 0)
+          return false;
+        else
+          pos = write_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    // assigns the arguments straight into a free slot (i.e. slot.assign(args...))
+    template<typename... Args>
+    bool try_emplace(Args&&... args)
+    {
+      return try_write([&](T& slot) { detail::assign_slot(slot, std::forward<Args>(args)...); });
+    }
+
+    // calls 'op(const T&)' on the oldest element and releases its slot; returns false if the queue is empty
+    template<typename Operation>
+    bool try_read(Operation op)
+    {
+      auto pos = read_pos_.load(std::memory_order_relaxed);
+      for(;;) {
+        auto& slot = slots_[pos & (Capacity - 1)];
+        const auto seq = slot.sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+        if(diff == 0) {
+          if(read_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+            if(!slot.valid) {
+              // left behind by a throwing try_write()
+              slot.sequence.store(pos + Capacity, std::memory_order_release);
+              pos = read_pos_.load(std::memory_order_relaxed);
+              continue;
+            }
+            try {
+              op(static_cast<const T&>(slot.value));
+            }
+            catch(...) {
+              slot.sequence.store(pos + Capacity, std::memory_order_release);
+              throw;
+            }
+            slot.sequence.store(pos + Capacity, std::memory_order_release);
+            return true;
+          }
+        }
+        else if(diff < 0)
+          return false;
+        else
+          pos = read_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    bool try_pop(T& value)
+    {
+      return try_read([&](const T& slot) { value = slot; });
+    }
+
+  private:
+    struct slot_type {
+      std::atomic<size_type> sequence;
+      bool valid = false;  // false if the operation writing 'value' threw
+      T value{};
+    };
+
+    alignas(detail::cache_line_size) std::atomic<size_type> write_pos_{0};
+    alignas(detail::cache_line_size) std::atomic<size_type> read_pos_{0};
+    alignas(detail::cache_line_size) std::array<slot_type, Capacity> slots_;
+  };
+}
@@ -0,0 +1,114 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <mp/inplace_string.h>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+namespace mp {
+
+  // Publishes a basic_inplace_string from a single writer thread to any number of reader threads.
+  //
+  // Readers never write to shared memory so they do not cause cache-line ping-pong between each
+  // other. They retry their copy if it overlapped with an update. The text is kept in relaxed atomic
+  // 64-bit words, which makes the racy copy well defined under the C++ memory model.
+  template<typename CharT, std::size_t MaxSize, typename Traits = std::char_traits<std::decay_t<CharT>>>
+  class alignas(64) basic_seqlock_inplace_string {
+  public:
+    using value_type = basic_inplace_string<CharT, MaxSize, Traits>;
+    static_assert(std::is_trivially_copyable_v<value_type>, "value_type must be trivially copyable");
+
+  private:
+    using word_type = std::uint64_t;
+    static constexpr std::size_t word_count = (sizeof(value_type) + sizeof(word_type) - 1) / sizeof(word_type);
+
+  public:
+    basic_seqlock_inplace_string() noexcept : basic_seqlock_inplace_string{value_type{}} {}
+    explicit basic_seqlock_inplace_string(const value_type& value) noexcept { write_words(value); }
+    basic_seqlock_inplace_string(const basic_seqlock_inplace_string&) = delete;
+    basic_seqlock_inplace_string& operator=(const basic_seqlock_inplace_string&) = delete;
+
+    // writer side (must not be called concurrently with itself)
+    void store(const value_type& value) noexcept
+    {
+      const auto seq = seq_.load(std::memory_order_relaxed);
+      seq_.store(seq + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      write_words(value);
+      seq_.store(seq + 2, std::memory_order_release);
+    }
+    template<typename Operation>
+    void update(Operation op)
+    {
+      auto value = read_words();
+      op(value);
+      store(value);
+    }
+
+    // reader side
+    value_type load() const noexcept
+    {
+      value_type value;
+      while(!try_load(value)) {
+      }
+      return value;
+    }
+    // a single attempt that fails if it overlapped with a store()
+    bool try_load(value_type& value) const noexcept
+    {
+      const auto seq = seq_.load(std::memory_order_acquire);
+      if(seq & 1) return false;
+      value = read_words();
+      std::atomic_thread_fence(std::memory_order_acquire);
+      return seq_.load(std::memory_order_relaxed) == seq;
+    }
+    operator value_type() const noexcept { return load(); }
+
+  private:
+    std::atomic<std::uint64_t> seq_{0};
+    std::atomic<word_type> words_[word_count];
+
+    void write_words(const value_type& value) noexcept
+    {
+      word_type buffer[word_count] = {};
+      std::memcpy(buffer, &value, sizeof(value));
+      for(std::size_t i = 0; i < word_count; ++i) words_[i].store(buffer[i], std::memory_order_relaxed);
+    }
+    value_type read_words() const noexcept
+    {
+      word_type buffer[word_count];
+      for(std::size_t i = 0; i < word_count; ++i) buffer[i] = words_[i].load(std::memory_order_relaxed);
+      value_type value;
+      std::memcpy(&value, buffer, sizeof(value));
+      return value;
+    }
+  };
+
+  // aliases
+  template<std::size_t MaxSize>
+  using seqlock_inplace_string = basic_seqlock_inplace_string<char, MaxSize>;
+  template<std::size_t MaxSize>
+  using seqlock_inplace_wstring = basic_seqlock_inplace_string<wchar_t, MaxSize>;
+}
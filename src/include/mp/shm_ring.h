@@ -0,0 +1,254 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// POSIX shared-memory broadcast ring of fixed-size records (e.g. structures of basic_inplace_string
+// fields which contain no pointers). Requires shm_open()/mmap() (link with -lrt on older glibc).
+
+namespace mp {
+
+  namespace detail {
+    constexpr std::uint64_t shm_ring_magic = 0x676E6972'5F6D6873ull;  // "shm_ring"
+
+    struct shm_ring_header {
+      std::atomic<std::uint64_t> magic;  // published last by the writer that initializes the segment
+      std::uint64_t record_size;
+      std::uint64_t capacity;
+      alignas(64) std::atomic<std::uint64_t> write_cursor;  // index of the next record to be written
+    };
+
+    template<typename T>
+    struct alignas(64) shm_ring_slot {
+      std::atomic<std::uint64_t> sequence;  // 2 * index + 1 while written, 2 * index + 2 when published
+      T record;
+    };
+
+    template<typename T, std::size_t Capacity>
+    struct shm_ring_layout {
+      shm_ring_header header;
+      shm_ring_slot<T> slots[Capacity];
+    };
+
+    class shm_mapping {
+    public:
+      // the writer validates an initialized segment against 'record_size' and 'capacity' before resizing it,
+      // so a mismatching writer cannot shrink a segment under mapped readers
+      shm_mapping(const std::string& name, std::size_t size, bool writer, std::uint64_t record_size,
+                  std::uint64_t capacity)
+          : size_{size}
+      {
+        const int fd =
+            writer ? ::shm_open(name.c_str(), O_CREAT | O_RDWR, 0600) : ::shm_open(name.c_str(), O_RDONLY, 0);
+        if(fd == -1) throw std::system_error(errno, std::generic_category(), "mp::shm_ring: shm_open() failed");
+        struct stat st{};
+        if(::fstat(fd, &st) == -1) {
+          const int error = errno;
+          ::close(fd);
+          throw std::system_error(error, std::generic_category(), "mp::shm_ring: fstat() failed");
+        }
+        if(writer) {
+          std::uint64_t header[3] = {};  // magic, record_size, capacity
+          const bool initialized = static_cast<std::size_t>(st.st_size) >= sizeof(header) &&
+                                   ::pread(fd, header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+                                   header[0] == shm_ring_magic;
+          if(initialized && (header[1] != record_size || header[2] != capacity)) {
+            ::close(fd);
+            throw std::runtime_error("mp::shm_ring_writer: segment '" + name + "' has a different layout");
+          }
+          if(!initialized && ::ftruncate(fd, static_cast<off_t>(size)) == -1) {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "mp::shm_ring: ftruncate() failed");
+          }
+        }
+        else if(static_cast<std::size_t>(st.st_size) < size) {
+          ::close(fd);
+          throw std::runtime_error("mp::shm_ring: shared memory segment too small");
+        }
+        data_ = ::mmap(nullptr, size, writer ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+        const int error = errno;
+        ::close(fd);
+        if(data_ == MAP_FAILED) throw std::system_error(error, std::generic_category(), "mp::shm_ring: mmap() failed");
+      }
+      shm_mapping(const shm_mapping&) = delete;
+      shm_mapping& operator=(const shm_mapping&) = delete;
+      ~shm_mapping() { ::munmap(data_, size_); }
+
+      void* data() const { return data_; }
+
+    private:
+      void* data_;
+      std::size_t size_;
+    };
+
+    template<typename T, std::size_t Capacity>
+    struct shm_ring_base {
+      static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
+      static_assert(std::is_trivially_copyable_v<T> && std::is_standard_layout_v<T>,
+                    "records shared between processes must be trivially copyable and standard layout");
+      static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "address-free 64-bit atomics are required");
+      using layout_type = shm_ring_layout<T, Capacity>;
+    };
+  }
+
+  // Writer side of a shared-memory broadcast ring (at most one writer process per ring).
+  //
+  // The writer never waits for readers: it overwrites the oldest record once the ring is full and
+  // readers detect that they were overrun. Readers never write to the segment, so a crashed reader
+  // cannot affect anybody. The write cursor lives in the segment, so a restarted writer continues
+  // where the previous one stopped (re-writing a record it may have left half-written).
+  template<typename T, std::size_t Capacity>
+  class shm_ring_writer : detail::shm_ring_base<T, Capacity> {
+    using layout_type = typename detail::shm_ring_base<T, Capacity>::layout_type;
+
+  public:
+    explicit shm_ring_writer(const std::string& name)
+        : mapping_{name, sizeof(layout_type), true, sizeof(T), Capacity},
+          layout_{static_cast<layout_type*>(mapping_.data())}
+    {
+      auto& header = layout_->header;
+      if(header.magic.load(std::memory_order_acquire) == detail::shm_ring_magic) {
+        if(header.record_size != sizeof(T) || header.capacity != Capacity)
+          throw std::runtime_error("mp::shm_ring_writer: segment '" + name + "' has a different layout");
+      }
+      else {
+        header.record_size = sizeof(T);
+        header.capacity = Capacity;
+        header.write_cursor.store(0, std::memory_order_relaxed);
+        for(auto& slot : layout_->slots) slot.sequence.store(0, std::memory_order_relaxed);
+        header.magic.store(detail::shm_ring_magic, std::memory_order_release);
+      }
+    }
+
+    static void unlink(const std::string& name) { ::shm_unlink(name.c_str()); }
+
+    // calls 'op(T&)' on the next slot of the ring and publishes it
+    template<typename Operation>
+    void write(Operation op)
+    {
+      auto& header = layout_->header;
+      const auto index = header.write_cursor.load(std::memory_order_relaxed);
+      auto& slot = layout_->slots[index & (Capacity - 1)];
+      slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      op(slot.record);
+      slot.sequence.store(2 * index + 2, std::memory_order_release);
+      header.write_cursor.store(index + 1, std::memory_order_release);
+    }
+    void push(const T& record)
+    {
+      write([&](T& slot) { slot = record; });
+    }
+
+    std::uint64_t cursor() const noexcept { return layout_->header.write_cursor.load(std::memory_order_relaxed); }
+
+  private:
+    detail::shm_mapping mapping_;
+    layout_type* layout_;
+  };
+
+  enum class shm_read_status { ok, empty, overrun };
+
+  // Reader side of a shared-memory broadcast ring; any number of reader processes may attach.
+  //
+  // Records are viewed in place in the read-only mapping. Since the writer may overwrite a record that
+  // is being viewed, the view is validated after use and reported as an overrun if it was torn.
+  template<typename T, std::size_t Capacity>
+  class shm_ring_reader : detail::shm_ring_base<T, Capacity> {
+    using layout_type = typename detail::shm_ring_base<T, Capacity>::layout_type;
+
+  public:
+    enum class start { latest, oldest };
+
+    explicit shm_ring_reader(const std::string& name, start from = start::latest)
+        : mapping_{name, sizeof(layout_type), false, sizeof(T), Capacity},
+          layout_{static_cast<const layout_type*>(mapping_.data())}
+    {
+      const auto& header = layout_->header;
+      if(header.magic.load(std::memory_order_acquire) != detail::shm_ring_magic)
+        throw std::runtime_error("mp::shm_ring_reader: segment '" + name + "' is not initialized");
+      if(header.record_size != sizeof(T) || header.capacity != Capacity)
+        throw std::runtime_error("mp::shm_ring_reader: segment '" + name + "' has a different layout");
+      cursor_ = from == start::latest ? write_cursor() : oldest();
+    }
+
+    // calls 'op(const T&)' on the next record in place; the record may only be trusted if 'ok' is returned
+    template<typename Operation>
+    shm_read_status try_read(Operation op)
+    {
+      const auto& slot = layout_->slots[cursor_ & (Capacity - 1)];
+      const auto expected = 2 * cursor_ + 2;
+      const auto sequence = slot.sequence.load(std::memory_order_acquire);
+      if(sequence < expected) return shm_read_status::empty;
+      if(sequence == expected) {
+        op(slot.record);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(slot.sequence.load(std::memory_order_relaxed) == expected) {
+          ++cursor_;
+          return shm_read_status::ok;
+        }
+      }
+      const auto resume = oldest();
+      lost_ += resume > cursor_ ? resume - cursor_ : 1;
+      cursor_ = resume > cursor_ ? resume : cursor_ + 1;
+      return shm_read_status::overrun;
+    }
+    shm_read_status try_pop(T& record)
+    {
+      return try_read([&](const T& slot) { record = slot; });
+    }
+
+    std::uint64_t cursor() const noexcept { return cursor_; }
+    std::uint64_t lost() const noexcept { return lost_; }
+
+  private:
+    detail::shm_mapping mapping_;
+    const layout_type* layout_;
+    std::uint64_t cursor_ = 0;
+    std::uint64_t lost_ = 0;
+
+    std::uint64_t write_cursor() const noexcept
+    {
+      return layout_->header.write_cursor.load(std::memory_order_acquire);
+    }
+    // the slot of the record being written next is the only one that may be unstable
+    std::uint64_t oldest() const noexcept
+    {
+      const auto w = write_cursor();
+      return w >= Capacity ? w - Capacity + 1 : 0;
+    }
+  };
+}
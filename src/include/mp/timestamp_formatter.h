@@ -0,0 +1,178 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <mp/inplace_string.h>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <ratio>
+#include <stdexcept>
+
+namespace mp {
+
+  enum class timestamp_format {
+    iso8601,    // 2000-10-10T13:55:36.123456Z or 2000-10-10T13:55:36.123456+02:00
+    common_log  // [10/Oct/2000:13:55:36 -0700] (no sub-second digits)
+  };
+
+  // Renders std::chrono::system_clock time points into an inplace_string<32>.
+  //
+  // The text is kept between calls: the date and time are rewritten only when the minute changes, the
+  // seconds digits when the second changes and otherwise only the sub-second digits (Precision selects
+  // seconds, milliseconds, microseconds or nanoseconds), so consecutive timestamps cost a few stores.
+  // The time is rendered with a fixed UTC offset. An instance must not be shared between threads.
+  template<typename Precision = std::chrono::microseconds>
+  class timestamp_formatter {
+    static_assert(Precision::period::num == 1 &&
+                      (Precision::period::den == 1 || Precision::period::den == 1000 ||
+                       Precision::period::den == 1'000'000 || Precision::period::den == 1'000'000'000),
+                  "seconds, milliseconds, microseconds or nanoseconds precision expected");
+    static constexpr std::size_t fraction_digits = Precision::period::den == 1      ? 0
+                                                   : Precision::period::den == 1000 ? 3
+                                                   : Precision::period::den == 1'000'000 ? 6
+                                                                                         : 9;
+
+    struct layout {
+      std::size_t size, year, month, day, hour, minute, second;
+    };
+    static constexpr layout iso8601_layout = {0, 0, 5, 8, 11, 14, 17};
+    static constexpr layout common_log_layout = {28, 8, 4, 1, 13, 16, 19};
+
+  public:
+    using string_type = inplace_string<32>;
+
+    explicit timestamp_formatter(timestamp_format format = timestamp_format::iso8601,
+                                 std::chrono::minutes utc_offset = std::chrono::minutes{0})
+        : format_{format},
+          offset_{utc_offset},
+          layout_{format == timestamp_format::iso8601 ? iso8601_layout : common_log_layout}
+    {
+      const auto offset = utc_offset.count();
+      if(offset <= -24 * 60 || offset >= 24 * 60)
+        throw std::out_of_range("mp::timestamp_formatter: UTC offset out of range");
+      const char sign = offset < 0 ? '-' : '+';
+      const auto abs_offset = static_cast<std::uint64_t>(offset < 0 ? -offset : offset);
+      if(format == timestamp_format::iso8601) {
+        const std::size_t zone = layout_.second + 2 + (fraction_digits > 0 ? 1 + fraction_digits : 0);
+        layout_.size = zone + (offset == 0 ? 1 : 6);
+        if(layout_.size > str_.max_size())
+          throw std::invalid_argument("mp::timestamp_formatter: nanoseconds with UTC offset do not fit");
+        str_.assign(layout_.size, '0');
+        char* p = str_.data();
+        p[4] = p[7] = '-';
+        p[10] = 'T';
+        p[13] = p[16] = ':';
+        if(fraction_digits > 0) p[19] = '.';
+        if(offset == 0)
+          p[zone] = 'Z';
+        else {
+          p[zone] = sign;
+          detail::write_digits(p + zone + 3, abs_offset / 60, 2);
+          p[zone + 3] = ':';
+          detail::write_digits(p + zone + 6, abs_offset % 60, 2);
+        }
+      }
+      else {
+        str_.assign("[01/Jan/1970:00:00:00 +0000]");
+        char* p = str_.data();
+        p[22] = sign;
+        detail::write_digits(p + 25, abs_offset / 60, 2);
+        detail::write_digits(p + 27, abs_offset % 60, 2);
+      }
+    }
+
+    template<typename Duration>
+    const string_type& operator()(std::chrono::time_point<std::chrono::system_clock, Duration> tp)
+    {
+      const auto local = std::chrono::floor<Precision>(tp) + offset_;
+      const auto seconds = std::chrono::floor<std::chrono::seconds>(local);
+      const std::int64_t s = seconds.time_since_epoch().count();
+      if(s != cached_second_) update_second(s);
+      if constexpr(fraction_digits > 0) {
+        if(format_ == timestamp_format::iso8601) {
+          const auto fraction = static_cast<std::uint64_t>((local - seconds).count());
+          detail::write_digits(str_.data() + 20 + fraction_digits, fraction, fraction_digits);
+        }
+      }
+      return str_;
+    }
+
+    const string_type& str() const noexcept { return str_; }
+
+  private:
+    string_type str_;
+    timestamp_format format_;
+    std::chrono::minutes offset_;
+    layout layout_;
+    std::int64_t cached_second_ = std::numeric_limits<std::int64_t>::min();
+    std::int64_t cached_minute_ = std::numeric_limits<std::int64_t>::min();
+
+    static constexpr std::int64_t floor_div(std::int64_t a, std::int64_t b)
+    {
+      return a / b - (a % b != 0 && (a < 0) != (b < 0));
+    }
+
+    void update_second(std::int64_t s)
+    {
+      const auto minute = floor_div(s, 60);
+      if(minute != cached_minute_) update_minute(minute);
+      detail::write_digits(str_.data() + layout_.second + 2, static_cast<std::uint64_t>(s - minute * 60), 2);
+      cached_second_ = s;
+    }
+
+    void update_minute(std::int64_t minute)
+    {
+      const auto days = floor_div(minute, 24 * 60);
+      const auto minute_of_day = static_cast<std::uint64_t>(minute - days * 24 * 60);
+
+      // civil date from days since 1970-01-01 (H. Hinnant's days_from_civil inverse)
+      const std::int64_t z = days + 719468;
+      const std::int64_t era = floor_div(z, 146097);
+      const auto doe = static_cast<std::uint64_t>(z - era * 146097);
+      const auto yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+      const auto doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+      const auto mp = (5 * doy + 2) / 153;
+      const auto day = doy - (153 * mp + 2) / 5 + 1;
+      const auto month = mp < 10 ? mp + 3 : mp - 9;
+      const std::int64_t year = static_cast<std::int64_t>(yoe) + era * 400 + (month <= 2);
+      if(year < 0 || year > 9999) throw std::out_of_range("mp::timestamp_formatter: year out of range");
+
+      char* p = str_.data();
+      detail::write_digits(p + layout_.year + 4, static_cast<std::uint64_t>(year), 4);
+      if(format_ == timestamp_format::iso8601)
+        detail::write_digits(p + layout_.month + 2, month, 2);
+      else {
+        constexpr char names[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+        p[layout_.month] = names[3 * (month - 1)];
+        p[layout_.month + 1] = names[3 * (month - 1) + 1];
+        p[layout_.month + 2] = names[3 * (month - 1) + 2];
+      }
+      detail::write_digits(p + layout_.day + 2, day, 2);
+      detail::write_digits(p + layout_.hour + 2, minute_of_day / 60, 2);
+      detail::write_digits(p + layout_.minute + 2, minute_of_day % 60, 2);
+      cached_minute_ = minute;
+    }
+  };
+
+}
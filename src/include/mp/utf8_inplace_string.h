@@ -0,0 +1,416 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <mp/inplace_string.h>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <string_view>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+namespace mp {
+
+  namespace detail {
+
+    // Reference validator following Unicode Table 3-7 (no overlongs, surrogates or values above U+10FFFF).
+    // ASCII runs are skipped 16 (SSE2) or 8 (SWAR) bytes at a time.
+    inline bool is_valid_utf8_scalar(const unsigned char* p, std::size_t n) noexcept
+    {
+      const unsigned char* const end = p + n;
+      while(p != end) {
+#if defined(__SSE2__) || defined(_M_X64)
+        while(end - p >= 16 && _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) == 0) p += 16;
+#else
+        for(std::uint64_t w; end - p >= 8; p += 8) {
+          std::memcpy(&w, p, sizeof(w));
+          if(w & 0x8080808080808080) break;
+        }
+#endif
+        if(p == end) break;
+        const unsigned c = *p;
+        if(c < 0x80) {
+          ++p;
+          continue;
+        }
+        std::size_t length;
+        unsigned lo = 0x80, hi = 0xBF;
+        if(c >= 0xC2 && c <= 0xDF)
+          length = 2;
+        else if(c >= 0xE0 && c <= 0xEF) {
+          length = 3;
+          if(c == 0xE0) lo = 0xA0;
+          if(c == 0xED) hi = 0x9F;
+        }
+        else if(c >= 0xF0 && c <= 0xF4) {
+          length = 4;
+          if(c == 0xF0) lo = 0x90;
+          if(c == 0xF4) hi = 0x8F;
+        }
+        else
+          return false;
+        if(static_cast<std::size_t>(end - p) < length || p[1] < lo || p[1] > hi) return false;
+        for(std::size_t i = 2; i < length; ++i)
+          if((p[i] & 0xC0) != 0x80) return false;
+        p += length;
+      }
+      return true;
+    }
+
+#if defined(__SSSE3__)
+    // J. Keiser, D. Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte": every error is a property
+    // of a pair of adjacent bytes (looked up by their nibbles) or of a missing 3rd/4th continuation byte
+    namespace utf8 {
+      constexpr std::uint8_t too_short = 1 << 0;       // 11______ 0_______
+      constexpr std::uint8_t too_long = 1 << 1;        // 0_______ 10______
+      constexpr std::uint8_t overlong_3 = 1 << 2;      // 11100000 100_____
+      constexpr std::uint8_t too_large = 1 << 3;       // 11110100 1001____, 11110100 101_____, 11110101+
+      constexpr std::uint8_t surrogate = 1 << 4;       // 11101101 101_____
+      constexpr std::uint8_t overlong_2 = 1 << 5;      // 1100000_ 10______
+      constexpr std::uint8_t too_large_1000 = 1 << 6;  // 11110101+ 1000____
+      constexpr std::uint8_t overlong_4 = 1 << 6;      // 11110000 1000____
+      constexpr std::uint8_t two_conts = 1 << 7;       // 10______ 10______
+      constexpr std::uint8_t carry = too_short | too_long | two_conts;
+
+      alignas(16) constexpr std::uint8_t byte_1_high[16] = {
+          too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long,
+          two_conts, two_conts, two_conts, two_conts,
+          too_short | overlong_2,
+          too_short,
+          too_short | overlong_3 | surrogate,
+          too_short | too_large | too_large_1000 | overlong_4};
+      alignas(16) constexpr std::uint8_t byte_1_low[16] = {
+          carry | overlong_3 | overlong_2 | overlong_4,
+          carry | overlong_2,
+          carry,
+          carry,
+          carry | too_large,
+          carry | too_large | too_large_1000,
+          carry | too_large | too_large_1000,
+          carry | too_large | too_large_1000,
+          carry | too_large | too_large_1000,
+          carry | too_large | too_large_1000,
+          carry | too_large | too_large_1000,
+          carry | too_large | too_large_1000,
+          carry | too_large | too_large_1000,
+          carry | too_large | too_large_1000 | surrogate,
+          carry | too_large | too_large_1000,
+          carry | too_large | too_large_1000};
+      alignas(16) constexpr std::uint8_t byte_2_high[16] = {
+          too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+          too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+          too_long | overlong_2 | two_conts | overlong_3 | too_large,
+          too_long | overlong_2 | two_conts | surrogate | too_large,
+          too_long | overlong_2 | two_conts | surrogate | too_large,
+          too_short, too_short, too_short, too_short};
+      // bytes above these values at the end of a block start a sequence that continues in the next block
+      alignas(16) constexpr std::uint8_t incomplete_limit[16] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                                                                 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF};
+
+      inline __m128i load(const std::uint8_t (&table)[16]) noexcept
+      {
+        return _mm_load_si128(reinterpret_cast<const __m128i*>(table));
+      }
+
+      inline __m128i block_errors(__m128i input, __m128i prev_input) noexcept
+      {
+        const __m128i mask = _mm_set1_epi8(0x0F);
+        const __m128i prev1 = _mm_alignr_epi8(input, prev_input, 15);
+        const __m128i b1_high = _mm_shuffle_epi8(load(byte_1_high), _mm_and_si128(_mm_srli_epi16(prev1, 4), mask));
+        const __m128i b1_low = _mm_shuffle_epi8(load(byte_1_low), _mm_and_si128(prev1, mask));
+        const __m128i b2_high = _mm_shuffle_epi8(load(byte_2_high), _mm_and_si128(_mm_srli_epi16(input, 4), mask));
+        const __m128i special = _mm_and_si128(_mm_and_si128(b1_high, b1_low), b2_high);
+        // only 111_____ (3rd byte) and 1111____ (4th byte) leads end up with the top bit set
+        const __m128i third = _mm_subs_epu8(_mm_alignr_epi8(input, prev_input, 14), _mm_set1_epi8(0xE0 - 0x80));
+        const __m128i fourth = _mm_subs_epu8(_mm_alignr_epi8(input, prev_input, 13), _mm_set1_epi8(0xF0 - 0x80));
+        const __m128i must_continue =
+            _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(static_cast<char>(0x80)));
+        return _mm_xor_si128(must_continue, special);
+      }
+    }
+#endif
+
+    inline bool is_valid_utf8(const void* data, std::size_t size) noexcept
+    {
+      auto p = static_cast<const unsigned char*>(data);
+#if defined(__SSSE3__)
+      __m128i error = _mm_setzero_si128();
+      __m128i prev_input = _mm_setzero_si128();
+      __m128i prev_incomplete = _mm_setzero_si128();
+      const auto step = [&](__m128i input) {
+        if(_mm_movemask_epi8(input) == 0)
+          error = _mm_or_si128(error, prev_incomplete);
+        else {
+          error = _mm_or_si128(error, utf8::block_errors(input, prev_input));
+          prev_incomplete = _mm_subs_epu8(input, utf8::load(utf8::incomplete_limit));
+        }
+        prev_input = input;
+      };
+      for(; size >= 16; size -= 16, p += 16) step(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+      // the zero padding (at least one byte) also catches a sequence truncated at the end of the input
+      alignas(16) unsigned char tail[16] = {};
+      std::memcpy(tail, p, size);
+      step(_mm_load_si128(reinterpret_cast<const __m128i*>(tail)));
+      return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) == 0xFFFF;
+#else
+      return is_valid_utf8_scalar(p, size);
+#endif
+    }
+
+    // the largest position not above 'pos' that does not split a code point of valid UTF-8 text
+    template<typename CharT>
+    constexpr std::size_t utf8_boundary(const CharT* text, std::size_t size, std::size_t pos) noexcept
+    {
+      if(pos >= size) return size;
+      for(int i = 0; i < 3 && pos > 0 && (static_cast<unsigned char>(text[pos]) & 0xC0) == 0x80; ++i) --pos;
+      return pos;
+    }
+
+    // 1 to 4 code units; 0 for a surrogate or a value above U+10FFFF
+    template<typename CharT>
+    constexpr std::size_t encode_utf8(char32_t cp, CharT* out) noexcept
+    {
+      if(cp < 0x80) {
+        out[0] = static_cast<CharT>(cp);
+        return 1;
+      }
+      if(cp < 0x800) {
+        out[0] = static_cast<CharT>(0xC0 | (cp >> 6));
+        out[1] = static_cast<CharT>(0x80 | (cp & 0x3F));
+        return 2;
+      }
+      if(cp >= 0xD800 && cp <= 0xDFFF) return 0;
+      if(cp < 0x10000) {
+        out[0] = static_cast<CharT>(0xE0 | (cp >> 12));
+        out[1] = static_cast<CharT>(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = static_cast<CharT>(0x80 | (cp & 0x3F));
+        return 3;
+      }
+      if(cp > 0x10FFFF) return 0;
+      out[0] = static_cast<CharT>(0xF0 | (cp >> 18));
+      out[1] = static_cast<CharT>(0x80 | ((cp >> 12) & 0x3F));
+      out[2] = static_cast<CharT>(0x80 | ((cp >> 6) & 0x3F));
+      out[3] = static_cast<CharT>(0x80 | (cp & 0x3F));
+      return 4;
+    }
+
+  }  // namespace detail
+
+  // A basic_inplace_string that always holds well-formed UTF-8.
+  //
+  // Every assign and append validates its input (with SIMD when available) and reports malformed text with
+  // std::invalid_argument. Text that does not fit throws std::length_error like basic_inplace_string does,
+  // except for append_truncated() which keeps as many whole code points as fit. Only const access to the
+  // code units is provided so the invariant cannot be broken from outside.
+  template<typename CharT, std::size_t MaxSize, typename Traits = std::char_traits<CharT>>
+  class basic_utf8_inplace_string {
+    static_assert(sizeof(CharT) == 1, "UTF-8 code units must be 1 byte");
+
+  public:
+    using string_type = basic_inplace_string<CharT, MaxSize, Traits>;
+    using view_type = std::basic_string_view<CharT, Traits>;
+    using traits_type = Traits;
+    using value_type = CharT;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using const_pointer = const value_type*;
+    using const_reference = const value_type&;
+    using const_iterator = typename string_type::const_iterator;
+    using const_reverse_iterator = typename string_type::const_reverse_iterator;
+
+    // constructors
+    basic_utf8_inplace_string() = default;
+    explicit basic_utf8_inplace_string(view_type sv) { assign(sv); }
+    explicit basic_utf8_inplace_string(const CharT* s) { assign(view_type{s}); }
+
+    basic_utf8_inplace_string& operator=(view_type sv) { return assign(sv); }
+    basic_utf8_inplace_string& operator+=(view_type sv) { return append(sv); }
+    basic_utf8_inplace_string& operator+=(char32_t cp) { return append(cp); }
+
+    // assign/append: std::invalid_argument for malformed UTF-8, std::length_error if the text does not fit;
+    // the string is left unchanged in both cases
+    basic_utf8_inplace_string& assign(view_type sv)
+    {
+      check_valid(sv);
+      str_.assign(sv.data(), sv.size());
+      return *this;
+    }
+    basic_utf8_inplace_string& append(view_type sv)
+    {
+      if(sv.size() > max_size() - size()) throw std::length_error("mp::basic_utf8_inplace_string: size() > max_size()");
+      check_valid(sv);
+      str_.append(sv.data(), sv.size());
+      return *this;
+    }
+    basic_utf8_inplace_string& append(char32_t cp)
+    {
+      CharT buffer[4];
+      const auto n = detail::encode_utf8(cp, buffer);
+      if(n == 0) throw std::invalid_argument("mp::basic_utf8_inplace_string: invalid code point");
+      str_.append(buffer, n);
+      return *this;
+    }
+    void push_back(char32_t cp) { append(cp); }
+
+    // appends the longest prefix of 'sv' that fits without splitting a code point and returns its size
+    size_type append_truncated(view_type sv)
+    {
+      const auto n = detail::utf8_boundary(sv.data(), sv.size(), max_size() - size());
+      append(sv.substr(0, n));
+      return n;
+    }
+
+    // non-throwing variants returning parse_status::invalid or parse_status::out_of_range on failure
+    parse_status try_assign(view_type sv) noexcept
+    {
+      if(sv.size() > max_size()) return parse_status::out_of_range;
+      if(!detail::is_valid_utf8(sv.data(), sv.size())) return parse_status::invalid;
+      str_.assign(sv.data(), sv.size());
+      return parse_status::ok;
+    }
+    parse_status try_append(view_type sv) noexcept
+    {
+      if(sv.size() > max_size() - size()) return parse_status::out_of_range;
+      if(!detail::is_valid_utf8(sv.data(), sv.size())) return parse_status::invalid;
+      str_.append(sv.data(), sv.size());
+      return parse_status::ok;
+    }
+
+    // removes the last code point
+    void pop_back() noexcept
+    {
+      if(!empty()) str_.resize(detail::utf8_boundary(data(), size(), size() - 1));
+    }
+    void clear() noexcept { str_.clear(); }
+
+    // element access
+    const_reference operator[](size_type pos) const { return str_[pos]; }
+    const_reference at(size_type pos) const { return str_.at(pos); }
+    const_pointer data() const noexcept { return str_.data(); }
+    const_pointer c_str() const noexcept { return str_.c_str(); }
+    const string_type& str() const noexcept { return str_; }
+    operator view_type() const noexcept { return str_; }
+
+    // iterators
+    const_iterator begin() const noexcept { return str_.begin(); }
+    const_iterator end() const noexcept { return str_.end(); }
+    const_iterator cbegin() const noexcept { return str_.cbegin(); }
+    const_iterator cend() const noexcept { return str_.cend(); }
+    const_reverse_iterator rbegin() const noexcept { return str_.rbegin(); }
+    const_reverse_iterator rend() const noexcept { return str_.rend(); }
+
+    // capacity
+    bool empty() const noexcept { return str_.empty(); }
+    size_type size() const noexcept { return str_.size(); }
+    size_type length() const noexcept { return str_.length(); }
+    constexpr size_type max_size() const noexcept { return MaxSize; }
+
+  private:
+    string_type str_;
+
+    static void check_valid(view_type sv)
+    {
+      if(!detail::is_valid_utf8(sv.data(), sv.size()))
+        throw std::invalid_argument("mp::basic_utf8_inplace_string: invalid UTF-8");
+    }
+  };
+
+  // relational operators
+  template<typename CharT, std::size_t MaxSize, class Traits>
+  bool operator==(const basic_utf8_inplace_string<CharT, MaxSize, Traits>& lhs,
+                  const basic_utf8_inplace_string<CharT, MaxSize, Traits>& rhs)
+  {
+    return std::basic_string_view<CharT, Traits>{lhs} == std::basic_string_view<CharT, Traits>{rhs};
+  }
+
+  template<typename CharT, std::size_t MaxSize, class Traits>
+  bool operator!=(const basic_utf8_inplace_string<CharT, MaxSize, Traits>& lhs,
+                  const basic_utf8_inplace_string<CharT, MaxSize, Traits>& rhs)
+  {
+    return !(lhs == rhs);
+  }
+
+  template<typename CharT, std::size_t MaxSize, class Traits>
+  bool operator<(const basic_utf8_inplace_string<CharT, MaxSize, Traits>& lhs,
+                 const basic_utf8_inplace_string<CharT, MaxSize, Traits>& rhs)
+  {
+    return std::basic_string_view<CharT, Traits>{lhs} < std::basic_string_view<CharT, Traits>{rhs};
+  }
+
+  // comparison with c-style string
+  template<typename CharT, std::size_t MaxSize, class Traits>
+  bool operator==(const CharT* lhs, const basic_utf8_inplace_string<CharT, MaxSize, Traits>& rhs)
+  {
+    return std::basic_string_view<CharT, Traits>{lhs} == std::basic_string_view<CharT, Traits>{rhs};
+  }
+
+  template<typename CharT, std::size_t MaxSize, class Traits>
+  bool operator==(const basic_utf8_inplace_string<CharT, MaxSize, Traits>& lhs, const CharT* rhs)
+  {
+    return std::basic_string_view<CharT, Traits>{lhs} == std::basic_string_view<CharT, Traits>{rhs};
+  }
+
+  template<typename CharT, std::size_t MaxSize, class Traits>
+  bool operator!=(const CharT* lhs, const basic_utf8_inplace_string<CharT, MaxSize, Traits>& rhs)
+  {
+    return !(lhs == rhs);
+  }
+
+  template<typename CharT, std::size_t MaxSize, class Traits>
+  bool operator!=(const basic_utf8_inplace_string<CharT, MaxSize, Traits>& lhs, const CharT* rhs)
+  {
+    return !(lhs == rhs);
+  }
+
+  // input/output
+  template<std::size_t MaxSize, class Traits>
+  inline std::basic_ostream<char, Traits>& operator<<(std::basic_ostream<char, Traits>& os,
+                                                      const basic_utf8_inplace_string<char, MaxSize, Traits>& v)
+  {
+    return os << std::basic_string_view<char, Traits>{v};
+  }
+
+  // aliases
+  template<std::size_t MaxSize>
+  using utf8_inplace_string = basic_utf8_inplace_string<char, MaxSize>;
+#if defined(__cpp_char8_t)
+  template<std::size_t MaxSize>
+  using utf8_inplace_u8string = basic_utf8_inplace_string<char8_t, MaxSize>;
+#endif
+}
+
+namespace std {
+  template<typename CharT, std::size_t MaxSize, typename Traits>
+  struct hash<mp::basic_utf8_inplace_string<CharT, MaxSize, Traits>> {
+    std::size_t operator()(const mp::basic_utf8_inplace_string<CharT, MaxSize, Traits>& v) const noexcept
+    {
+      return mp::hash_value(v.str());
+    }
+  };
+}
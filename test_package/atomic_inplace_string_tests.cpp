@@ -0,0 +1,106 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <mp/atomic_inplace_string.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+// explicit instantiation needed to make code coverage metrics work correctly
+template class mp::basic_atomic_inplace_string<char, 15, std::char_traits<char>>;
+
+using namespace mp;
+
+namespace {
+  template<typename Atomic>
+  void concurrent_increments()
+  {
+    using value_type = typename Atomic::value_type;
+    Atomic counter{value_type{"0"}};
+    constexpr int threads_count = 4;
+    constexpr int increments = 10000;
+
+    std::vector<std::thread> threads;
+    for(int i = 0; i < threads_count; ++i)
+      threads.emplace_back([&] {
+        for(int j = 0; j < increments; ++j) {
+          auto expected = counter.load();
+          value_type desired;
+          do {
+            desired = value_type{std::to_string(std::stoi(expected.c_str()) + 1).c_str()};
+          } while(!counter.compare_exchange_weak(expected, desired));
+        }
+      });
+    for(auto& t : threads) t.join();
+    EXPECT_EQ(std::to_string(threads_count * increments).c_str(), counter.load());
+  }
+}
+
+TEST(atomicInplaceString, LockFree)
+{
+  static_assert(atomic_inplace_string<7>::is_always_lock_free, "");
+#if defined(__x86_64__) && defined(__GNUC__)
+  // -mcx16 is a requirement of the library target on x86-64
+  static_assert(atomic_inplace_string<15>::is_always_lock_free, "build with -mcx16");
+#elif defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)
+  static_assert(atomic_inplace_string<15>::is_always_lock_free, "");
+#endif
+  static_assert(!atomic_inplace_string<16>::is_always_lock_free, "");
+  EXPECT_TRUE(atomic_inplace_string<3>{}.is_lock_free());
+}
+
+TEST(atomicInplaceString, Operations)
+{
+  atomic_inplace_string<15> str;
+  EXPECT_TRUE(str.load().empty());
+  str.store(inplace_string<15>{"RUNNING"});
+  EXPECT_EQ("RUNNING", str.load());
+  EXPECT_EQ("RUNNING", str.exchange(inplace_string<15>{"HALTED"}));
+  EXPECT_EQ("HALTED", static_cast<inplace_string<15>>(str));
+
+  // unused characters left by a longer value must not break the comparison
+  inplace_string<15> expected{"HALTED_LONGER"};
+  expected = "HALTED";
+  EXPECT_TRUE(str.compare_exchange_strong(expected, inplace_string<15>{"CLOSED"}));
+  EXPECT_EQ("CLOSED", str.load());
+  EXPECT_FALSE(str.compare_exchange_strong(expected, inplace_string<15>{"OPEN"}));
+  EXPECT_EQ("CLOSED", expected);
+}
+
+TEST(atomicInplaceString, SeqlockOperations)
+{
+  atomic_inplace_string<40> str{inplace_string<40>{"A"}};
+  inplace_string<40> expected{"B"};
+  EXPECT_FALSE(str.compare_exchange_strong(expected, inplace_string<40>{"C"}));
+  EXPECT_EQ("A", expected);
+  EXPECT_TRUE(str.compare_exchange_strong(expected, inplace_string<40>{"C"}));
+  EXPECT_EQ("C", str.exchange(inplace_string<40>{"D"}));
+  EXPECT_EQ("D", str.load());
+}
+
+TEST(atomicInplaceString, ConcurrentCompareExchange)
+{
+  concurrent_increments<atomic_inplace_string<7>>();
+  concurrent_increments<atomic_inplace_string<15>>();
+  concurrent_increments<atomic_inplace_string<31>>();
+}
@@ -0,0 +1,118 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <mp/batch_writer.h>
+#include <mp/inplace_string.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#if defined(MP_BATCH_WRITER_HAS_WRITEV)
+// explicit instantiation needed to make code coverage metrics work correctly
+template class mp::iovec_batch_writer<4>;
+#endif
+
+using namespace mp;
+
+namespace {
+  template<typename Writer, typename... Strings>
+  using add_t = decltype(std::declval<Writer&>().add(std::declval<Strings>()...));
+
+  template<typename Writer, typename = void, typename... Strings>
+  inline constexpr bool can_add = false;
+  template<typename Writer, typename... Strings>
+  inline constexpr bool can_add<Writer, std::void_t<add_t<Writer, Strings...>>, Strings...> = true;
+
+  std::string read_all(std::FILE* file)
+  {
+    std::string result;
+    std::rewind(file);
+    char buf[256];
+    for(std::size_t n; (n = std::fread(buf, 1, sizeof(buf), file)) > 0;) result.append(buf, n);
+    return result;
+  }
+}
+
+#if defined(MP_BATCH_WRITER_HAS_WRITEV)
+
+TEST(iovecBatchWriter, Write)
+{
+  std::FILE* file = std::tmpfile();
+  ASSERT_NE(file, nullptr);
+  {
+    iovec_batch_writer<4> writer{fileno(file)};
+    const inplace_string<8> symbol{"AAPL"};
+    const inplace_string<8> venue{"XNAS"};
+    const inplace_string<8> none;
+    writer.add(symbol, ",", venue, "\n");
+    EXPECT_EQ(writer.pending(), 4);
+    writer.add(none, symbol);
+    EXPECT_EQ(writer.pending(), 1);
+    writer.add("\n");
+    writer.flush();
+    EXPECT_EQ(writer.pending(), 0);
+    writer.add(venue);
+  }
+  EXPECT_EQ(read_all(file), "AAPL,XNAS\nAAPL\nXNAS");
+  std::fclose(file);
+}
+
+TEST(iovecBatchWriter, Lifetime)
+{
+  using writer = iovec_batch_writer<4>;
+  static_assert(can_add<writer, void, const inplace_string<8>&, const char (&)[2]>);
+  static_assert(can_add<writer, void, std::string&>);
+  static_assert(!can_add<writer, void, inplace_string<8>>);
+  static_assert(!can_add<writer, void, const inplace_string<8>&, std::string>);
+  static_assert(can_add<buffered_batch_writer, void, inplace_string<8>, std::string>);
+}
+
+TEST(iovecBatchWriter, Error)
+{
+  iovec_batch_writer<4> writer{-1};
+  writer.add("abc");
+  EXPECT_THROW(writer.flush(), std::system_error);
+  EXPECT_EQ(writer.pending(), 0);
+}
+
+#endif
+
+TEST(bufferedBatchWriter, Write)
+{
+  std::FILE* file = std::tmpfile();
+  ASSERT_NE(file, nullptr);
+  {
+    char buffer[8];
+    buffered_batch_writer writer{file, buffer};
+    writer.add(inplace_string<8>{"abc"}, ",", inplace_string<8>{"def"});
+    EXPECT_EQ(writer.pending(), 7);
+    writer.add("gh");
+    EXPECT_EQ(writer.pending(), 2);
+    writer.add("0123456789");
+    EXPECT_EQ(writer.pending(), 0);
+    writer.add("xyz");
+  }
+  EXPECT_EQ(read_all(file), "abc,defgh0123456789xyz");
+  std::fclose(file);
+}
@@ -0,0 +1,215 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <mp/hybrid_string.h>
+#include <gtest/gtest.h>
+#include <sstream>
+
+// explicit instantiation needed to make code coverage metrics work correctly
+template class mp::basic_hybrid_string<char, 32, std::char_traits<char>>;
+
+using namespace mp;
+
+namespace {
+  // counts allocations and forwards them to the new/delete resource
+  class counting_resource : public std::pmr::memory_resource {
+  public:
+    int allocations = 0;
+    int deallocations = 0;
+
+  private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+      ++allocations;
+      return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+    {
+      ++deallocations;
+      std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+  };
+
+  struct default_resource_guard {
+    std::pmr::memory_resource* previous;
+    explicit default_resource_guard(std::pmr::memory_resource* r) : previous{std::pmr::set_default_resource(r)} {}
+    ~default_resource_guard() { std::pmr::set_default_resource(previous); }
+  };
+
+  // a fresh counting_resource for every test
+  counting_resource* current_resource = nullptr;
+  struct counting_policy {
+    static std::pmr::memory_resource* get() noexcept { return current_resource; }
+  };
+  struct resource_scope : counting_resource {
+    resource_scope() { current_resource = this; }
+    ~resource_scope() { current_resource = nullptr; }
+  };
+
+  template<std::size_t MaxSize>
+  using counted_string = hybrid_string<MaxSize, counting_policy>;
+}
+
+TEST(hybridString, CompileTime)
+{
+  static_assert(sizeof(hybrid_string<32>) == sizeof(inplace_string<32>), "");
+  static_assert(sizeof(hybrid_string<24>) == sizeof(inplace_string<24>), "");
+  static_assert(sizeof(hybrid_string<15>) == sizeof(inplace_string<15>), "");
+  static_assert(sizeof(hybrid_string<8>) == sizeof(inplace_string<8>), "");
+  static_assert(sizeof(hybrid_string<7>) == sizeof(void*) + 1, "");
+  static_assert(sizeof(counted_string<15>) == sizeof(inplace_string<15>), "");
+}
+
+TEST(hybridString, DefaultResource)
+{
+  counting_resource resource;
+  default_resource_guard guard{&resource};
+  hybrid_string<15> str{"0123456789abcde"};
+  EXPECT_TRUE(str.is_inline());
+  str += 'f';
+  EXPECT_FALSE(str.is_inline());
+  EXPECT_EQ(1, resource.allocations);
+  str.shrink_to_fit();
+  EXPECT_EQ(1, resource.allocations);
+}
+
+TEST(hybridString, Inline)
+{
+  resource_scope resource;
+  counted_string<32> str{"abc"};
+  str += "def";
+  str.push_back('g');
+  EXPECT_TRUE(str.is_inline());
+  EXPECT_EQ(7u, str.size());
+  EXPECT_EQ(32u, str.capacity());
+  EXPECT_STREQ("abcdefg", str.c_str());
+  EXPECT_EQ("abcdefg", str);
+  counted_string<32> copy{str};
+  EXPECT_EQ(str, copy);
+  EXPECT_EQ(0, resource.allocations);
+}
+
+TEST(hybridString, Spill)
+{
+  resource_scope resource;
+  {
+    const std::string long_text(100, 'x');
+    counted_string<32> str{std::string(32, 'a').c_str()};
+    EXPECT_TRUE(str.is_inline());
+    str.push_back('b');
+    EXPECT_FALSE(str.is_inline());
+    EXPECT_EQ(1, resource.allocations);
+    EXPECT_EQ(33u, str.size());
+    EXPECT_EQ(std::string(32, 'a') + 'b', str.c_str());
+    str.append(long_text.data(), long_text.size());
+    EXPECT_EQ(133u, str.size());
+    EXPECT_EQ(std::string(32, 'a') + 'b' + long_text, std::string(std::string_view{str}));
+    EXPECT_EQ('x', str.back());
+
+    counted_string<32> copy{str};
+    EXPECT_FALSE(copy.is_inline());
+    EXPECT_EQ(str, copy);
+
+    counted_string<32> moved{std::move(copy)};
+    EXPECT_TRUE(copy.empty());
+    EXPECT_TRUE(copy.is_inline());
+    EXPECT_EQ(str, moved);
+  }
+  EXPECT_EQ(resource.allocations, resource.deallocations);
+}
+
+TEST(hybridString, AppendSelf)
+{
+  hybrid_string<24> str{"0123456789abcdefghij"};
+  str.append(str.data(), str.size());
+  EXPECT_FALSE(str.is_inline());
+  EXPECT_EQ("0123456789abcdefghij0123456789abcdefghij", str);
+}
+
+TEST(hybridString, ShrinkToFit)
+{
+  resource_scope resource;
+  counted_string<32> str(40, '$');
+  EXPECT_FALSE(str.is_inline());
+  str.resize(4);
+  EXPECT_FALSE(str.is_inline());
+  str.shrink_to_fit();
+  EXPECT_TRUE(str.is_inline());
+  EXPECT_EQ("$$$$", str);
+  EXPECT_EQ(1, resource.allocations);
+  EXPECT_EQ(1, resource.deallocations);
+}
+
+TEST(hybridString, Assign)
+{
+  hybrid_string<24> str;
+  str = std::string_view{"a string that is definitely longer than 24 characters"};
+  EXPECT_FALSE(str.is_inline());
+  EXPECT_EQ("a string that is definitely longer than 24 characters", str);
+  str = "short";
+  EXPECT_EQ("short", str);
+  hybrid_string<24> other{"other"};
+  other = str;
+  EXPECT_EQ("short", other);
+  str.swap(other);
+  EXPECT_TRUE(str.is_inline());
+  EXPECT_FALSE(other.is_inline());
+}
+
+TEST(hybridString, Output)
+{
+  std::ostringstream os;
+  os << hybrid_string<24>{std::string(30, 'z').c_str()};
+  EXPECT_EQ(std::string(30, 'z'), os.str());
+}
+
+TEST(hybridString, SmallCapacities)
+{
+  resource_scope resource;
+  {
+    counted_string<7> str{"1234567"};
+    EXPECT_TRUE(str.is_inline());
+    EXPECT_EQ(7u, str.capacity());
+    str += "89";
+    EXPECT_FALSE(str.is_inline());
+    EXPECT_EQ("123456789", str);
+    str.resize(3);
+    str.shrink_to_fit();
+    EXPECT_TRUE(str.is_inline());
+    EXPECT_EQ("123", str);
+
+    counted_string<1> one;
+    one.push_back('a');
+    EXPECT_TRUE(one.is_inline());
+    one.push_back('b');
+    EXPECT_FALSE(one.is_inline());
+    EXPECT_STREQ("ab", one.c_str());
+
+    counted_string<15> fifteen{std::string(15, 'f').c_str()};
+    EXPECT_TRUE(fifteen.is_inline());
+    fifteen.append(std::string(20, 'g').c_str());
+    EXPECT_EQ(std::string(15, 'f') + std::string(20, 'g'), fifteen.c_str());
+  }
+  EXPECT_EQ(3, resource.allocations);
+  EXPECT_EQ(resource.allocations, resource.deallocations);
+}
@@ -0,0 +1,158 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <mp/inplace_codec.h>
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace mp;
+
+namespace {
+
+  std::string reference_base64(const std::string& bytes)
+  {
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    std::size_t i = 0;
+    for(; i + 3 <= bytes.size(); i += 3) {
+      const unsigned v = static_cast<unsigned char>(bytes[i]) << 16 | static_cast<unsigned char>(bytes[i + 1]) << 8 |
+                         static_cast<unsigned char>(bytes[i + 2]);
+      for(int s = 18; s >= 0; s -= 6) out += alphabet[(v >> s) & 0x3F];
+    }
+    if(i < bytes.size()) {
+      const bool two = bytes.size() - i == 2;
+      const unsigned v =
+          static_cast<unsigned char>(bytes[i]) << 16 | (two ? static_cast<unsigned char>(bytes[i + 1]) << 8 : 0);
+      out += alphabet[v >> 18];
+      out += alphabet[(v >> 12) & 0x3F];
+      out += two ? alphabet[(v >> 6) & 0x3F] : '=';
+      out += '=';
+    }
+    return out;
+  }
+
+  inplace_string<120> pattern(std::size_t size)
+  {
+    inplace_string<120> bytes;
+    for(std::size_t i = 0; i < size; ++i) bytes.push_back(static_cast<char>(i * 37 + 11));
+    return bytes;
+  }
+
+}
+
+TEST(codec, Capacities)
+{
+  static_assert(std::is_same_v<decltype(to_hex(std::array<std::uint8_t, 16>{})), inplace_string<32>>);
+  static_assert(std::is_same_v<decltype(to_hex(inplace_string<20>{})), inplace_string<40>>);
+  static_assert(std::is_same_v<decltype(to_base64(std::array<std::byte, 16>{})), inplace_string<24>>);
+  static_assert(std::is_same_v<decltype(to_base64(inplace_string<18>{})), inplace_string<24>>);
+  static_assert(std::is_same_v<decltype(from_hex(inplace_string<32>{}).value), inplace_string<16>>);
+  static_assert(std::is_same_v<decltype(from_base64(inplace_string<24>{}).value), inplace_string<18>>);
+}
+
+TEST(codec, Hex)
+{
+  EXPECT_EQ(to_hex(std::array<std::uint8_t, 4>{0xde, 0xad, 0xbe, 0xef}), "deadbeef");
+  EXPECT_EQ(to_hex(inplace_string<8>{}), "");
+  for(std::size_t size = 0; size <= 120; ++size) {
+    const auto bytes = pattern(size);
+    std::string expected;
+    for(unsigned char c : bytes) {
+      expected += "0123456789abcdef"[c >> 4];
+      expected += "0123456789abcdef"[c & 0x0F];
+    }
+    const auto hex = to_hex(bytes);
+    ASSERT_EQ(hex, expected.c_str()) << size;
+    const auto decoded = from_hex(hex);
+    ASSERT_TRUE(decoded) << size;
+    ASSERT_EQ(decoded.value, bytes) << size;
+  }
+  EXPECT_EQ(from_hex(inplace_string<8>{"DEADbeef"}).value, "\xde\xad\xbe\xef");
+}
+
+TEST(codec, HexInvalid)
+{
+  EXPECT_EQ(from_hex(inplace_string<8>{"abc"}).status, parse_status::invalid);
+  for(const char c : {'g', 'G', '/', ':', '@', '`', ' ', '\0', '\xff'}) {
+    for(std::size_t pos = 0; pos < 64; pos += 7) {
+      inplace_string<64> text(64, 'a');
+      text[pos] = c;
+      EXPECT_EQ(from_hex(text).status, parse_status::invalid) << pos << ' ' << int(c);
+    }
+  }
+  unsigned char buf[2];
+  EXPECT_EQ(from_hex("a1b2c3", buf, sizeof(buf)).status, parse_status::out_of_range);
+  const auto r = from_hex("a1b2", buf, sizeof(buf));
+  ASSERT_TRUE(r);
+  EXPECT_EQ(r.value, 2u);
+  EXPECT_EQ(buf[0], 0xa1);
+  EXPECT_EQ(buf[1], 0xb2);
+}
+
+TEST(codec, Base64)
+{
+  // RFC 4648 test vectors
+  EXPECT_EQ(to_base64(inplace_string<6>{""}), "");
+  EXPECT_EQ(to_base64(inplace_string<6>{"f"}), "Zg==");
+  EXPECT_EQ(to_base64(inplace_string<6>{"fo"}), "Zm8=");
+  EXPECT_EQ(to_base64(inplace_string<6>{"foo"}), "Zm9v");
+  EXPECT_EQ(to_base64(inplace_string<6>{"foob"}), "Zm9vYg==");
+  EXPECT_EQ(to_base64(inplace_string<6>{"fooba"}), "Zm9vYmE=");
+  EXPECT_EQ(to_base64(inplace_string<6>{"foobar"}), "Zm9vYmFy");
+  EXPECT_EQ(to_base64(std::array<std::uint8_t, 3>{0xfb, 0xff, 0xbf}), "+/+/");
+  for(std::size_t size = 0; size <= 120; ++size) {
+    const auto bytes = pattern(size);
+    const auto text = to_base64(bytes);
+    ASSERT_EQ(text, reference_base64(std::string(bytes.data(), bytes.size())).c_str()) << size;
+    const auto decoded = from_base64(text);
+    ASSERT_TRUE(decoded) << size;
+    ASSERT_EQ(decoded.value, bytes) << size;
+  }
+}
+
+TEST(codec, Base64Unpadded)
+{
+  EXPECT_EQ(from_base64(inplace_string<8>{"Zg"}).value, "f");
+  EXPECT_EQ(from_base64(inplace_string<8>{"Zm8"}).value, "fo");
+  EXPECT_EQ(from_base64(inplace_string<8>{"Zm9vYmE"}).value, "fooba");
+  EXPECT_EQ(from_base64(inplace_string<8>{"Zm9vY"}).status, parse_status::invalid);
+  EXPECT_EQ(from_base64(inplace_string<8>{"Zg="}).status, parse_status::invalid);
+  EXPECT_EQ(from_base64(inplace_string<8>{"Z==="}).status, parse_status::invalid);
+}
+
+TEST(codec, Base64Invalid)
+{
+  for(const char c : {'=', '-', '_', '.', ' ', '\0', '\x80', '\xff', '@', '[', '`', '{', ',', ':'}) {
+    for(std::size_t pos = 0; pos < 64; pos += 5) {
+      inplace_string<64> text(64, 'A');
+      text[pos] = c;
+      if(c == '=' && pos >= 62) continue;
+      EXPECT_EQ(from_base64(text).status, parse_status::invalid) << pos << ' ' << int(c);
+    }
+  }
+  unsigned char buf[2];
+  EXPECT_EQ(from_base64("Zm9v", buf, sizeof(buf)).status, parse_status::out_of_range);
+  const auto r = from_base64("Zm8=", buf, sizeof(buf));
+  ASSERT_TRUE(r);
+  EXPECT_EQ(r.value, 2u);
+}
@@ -0,0 +1,94 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <mp/inplace_escape.h>
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace mp;
+
+TEST(jsonEscape, Escape)
+{
+  static_assert(std::is_same_v<decltype(json_escape(inplace_string<8>{})), inplace_string<48>>);
+  static_assert(std::is_same_v<decltype(json_escape(inplace_string<64>{})), inplace_string<255>>);
+  EXPECT_EQ(json_escape(inplace_string<8>{"plain"}), "plain");
+  EXPECT_EQ(json_escape(inplace_string<32>{"a\"b\\c\nd\te\r\b\f"}), "a\\\"b\\\\c\\nd\\te\\r\\b\\f");
+  EXPECT_EQ(json_escape(inplace_string<8>(8, '\x01')), "\\u0001\\u0001\\u0001\\u0001\\u0001\\u0001\\u0001\\u0001");
+  EXPECT_EQ(json_escape(inplace_string<8>{"\x1f\x7f\xc3\xa9"}), "\\u001f\x7f\xc3\xa9");
+  // specials at every position of 16- and 8-byte blocks
+  for(std::size_t i = 0; i < 40; ++i) {
+    inplace_string<40> str(40, 'x');
+    str[i] = '"';
+    std::string expected(40, 'x');
+    expected.insert(i, 1, '\\');
+    expected[i + 1] = '"';
+    EXPECT_EQ(to_string(json_escape(str)), expected);
+  }
+  inplace_string<64> big(64, '\x01');
+  EXPECT_THROW(json_escape(big), std::length_error);
+}
+
+TEST(jsonEscape, Unescape)
+{
+  auto result = json_unescape(inplace_string<32>{"a\\\"b\\\\c\\/\\nd\\te\\r\\b\\f"});
+  EXPECT_EQ(result.status, parse_status::ok);
+  EXPECT_EQ(result.value, "a\"b\\c/\nd\te\r\b\f");
+  EXPECT_EQ(json_unescape(inplace_string<32>{"\\u0041\\u00e9\\u20AC"}).value, "A\xc3\xa9\xe2\x82\xac");
+  EXPECT_EQ(json_unescape(inplace_string<32>{"\\ud83d\\ude00!"}).value, "\xf0\x9f\x98\x80!");
+  EXPECT_EQ(json_unescape(inplace_string<8>{"plain"}).value, "plain");
+  EXPECT_EQ(json_unescape(inplace_string<8>{"a\\"}).status, parse_status::invalid);
+  EXPECT_EQ(json_unescape(inplace_string<8>{"\\x"}).status, parse_status::invalid);
+  EXPECT_EQ(json_unescape(inplace_string<8>{"\\u12g4"}).status, parse_status::invalid);
+  EXPECT_EQ(json_unescape(inplace_string<16>{"\\ud83d"}).status, parse_status::invalid);
+  EXPECT_EQ(json_unescape(inplace_string<16>{"\\ude00"}).status, parse_status::invalid);
+  EXPECT_EQ(json_unescape(inplace_string<16>{"\\ud83d\\u0041"}).status, parse_status::invalid);
+
+  const inplace_string<40> raw{"quote\" back\\ ctl\x02 tab\t \xc3\xa9"};
+  EXPECT_EQ(json_unescape(inplace_string<255>{json_escape(raw)}).value, "quote\" back\\ ctl\x02 tab\t \xc3\xa9");
+}
+
+TEST(csvEscape, Escape)
+{
+  static_assert(std::is_same_v<decltype(csv_escape(inplace_string<8>{})), inplace_string<18>>);
+  EXPECT_EQ(csv_escape(inplace_string<16>{"plain text"}), "plain text");
+  EXPECT_EQ(csv_escape(inplace_string<16>{"a,b"}), "\"a,b\"");
+  EXPECT_EQ(csv_escape(inplace_string<16>{"say \"hi\""}), "\"say \"\"hi\"\"\"");
+  EXPECT_EQ(csv_escape(inplace_string<16>{"line\nbreak"}), "\"line\nbreak\"");
+  EXPECT_EQ(csv_escape(inplace_string<16>{"a,b"}, '\t'), "a,b");
+  EXPECT_EQ(csv_escape(inplace_string<32>{"0123456789abcdef0123456789\tx"}, '\t'),
+            "\"0123456789abcdef0123456789\tx\"");
+  EXPECT_EQ(csv_escape(inplace_string<8>(8, '"')), "\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"");
+}
+
+TEST(csvEscape, Unescape)
+{
+  EXPECT_EQ(csv_unescape(inplace_string<16>{"plain"}).value, "plain");
+  EXPECT_EQ(csv_unescape(inplace_string<16>{"\"a,b\""}).value, "a,b");
+  EXPECT_EQ(csv_unescape(inplace_string<16>{"\"say \"\"hi\"\"\""}).value, "say \"hi\"");
+  EXPECT_EQ(csv_unescape(inplace_string<16>{"\"\""}).value, "");
+  EXPECT_TRUE(csv_unescape(inplace_string<16>{""}));
+  EXPECT_EQ(csv_unescape(inplace_string<16>{"\""}).status, parse_status::invalid);
+  EXPECT_EQ(csv_unescape(inplace_string<16>{"\"a\"b\""}).status, parse_status::invalid);
+  EXPECT_EQ(csv_unescape(inplace_string<16>{"a\"b"}).status, parse_status::invalid);
+  EXPECT_EQ(csv_unescape(inplace_string<16>{"\"ab"}).status, parse_status::invalid);
+}
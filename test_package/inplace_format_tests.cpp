@@ -0,0 +1,157 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#if defined(MP_TEST_WITH_FMT)
+#include <fmt/format.h>
+#endif
+#include <mp/inplace_format.h>
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace mp;
+
+TEST(formatToInplace, Basic)
+{
+  const inplace_string<8> symbol{"AAPL"};
+  const auto str = format_to_inplace<32>("{}:{:08}", symbol, 1234);
+  static_assert(std::is_same_v<decltype(str), const inplace_string<32>>);
+  EXPECT_EQ(str, "AAPL:00001234");
+  EXPECT_EQ(format_to_inplace<16>("no fields"), "no fields");
+  EXPECT_EQ(format_to_inplace<16>("{{{}}} }}{{", 7), "{7} }{");
+  EXPECT_EQ(format_to_inplace<16>("{}", "c-string"), "c-string");
+  EXPECT_EQ(format_to_inplace<16>("{}{}", std::string_view{"ab"}, std::string{"cd"}), "abcd");
+  EXPECT_EQ(format_to_inplace<16>("{} {}", 'x', true), "x true");
+  EXPECT_EQ(format_to_inplace<16>("{}", 1), "1");  // unused arguments are ignored
+}
+
+TEST(formatToInplace, Integers)
+{
+  EXPECT_EQ(format_to_inplace<32>("{}", std::numeric_limits<std::int64_t>::min()), "-9223372036854775808");
+  EXPECT_EQ(format_to_inplace<32>("{}", std::numeric_limits<std::uint64_t>::max()), "18446744073709551615");
+  EXPECT_EQ(format_to_inplace<32>("{:x} {:X} {:o} {:b}", 255, 255u, 8, std::uint8_t{5}), "ff FF 10 101");
+  EXPECT_EQ(format_to_inplace<32>("{:+} {: } {:+}", 5, 5, -5), "+5  5 -5");
+  EXPECT_EQ(format_to_inplace<32>("{:06} {:+06} {:06x}", -42, 42, 255), "-00042 +00042 0000ff");
+  EXPECT_EQ(format_to_inplace<32>("[{:<5}][{:^5}][{:>5}][{:*^6}]", 1, 2, 3, 4), "[1    ][  2  ][    3][**4***]");
+  EXPECT_EQ(format_to_inplace<32>("{:x}", -255), "-ff");
+}
+
+TEST(formatToInplace, Floating)
+{
+  EXPECT_EQ(format_to_inplace<32>("{} {}", 0.1, 1.5f), "0.1 1.5");
+  EXPECT_EQ(format_to_inplace<32>("{:.2f} {:.3e} {:.3}", 101.256, 1234.5, 2.0 / 3), "101.26 1.234e+03 0.667");
+  EXPECT_EQ(format_to_inplace<32>("{:08.2f}|{:<8.1f}|{:+.1F}", -3.14159, 2.25, 1.0), "-0003.14|2.2     |+1.0");
+  EXPECT_EQ(format_to_inplace<32>("{:E} {:G}", 1e-10, 1e-10), "1.000000E-10 1E-10");
+  EXPECT_EQ(format_to_inplace<32>("{}", -0.0), "-0");
+}
+
+TEST(formatToInplace, Strings)
+{
+  EXPECT_EQ(format_to_inplace<32>("[{:6}][{:>6}][{:^7}]", "ab", inplace_string<4>{"cd"}, std::string_view{"ef"}),
+            "[ab    ][    cd][  ef   ]");
+  EXPECT_EQ(format_to_inplace<32>("[{:.3}][{:-<6.2s}]", "abcdef", "xyz"), "[abc][xy----]");
+  EXPECT_EQ(format_to_inplace<32>("{:>3}{:3}", 'a', false), "  afalse");
+  EXPECT_EQ(format_to_inplace<32>(L"{}={:04}", L"wide", 42), L"wide=0042");
+}
+
+TEST(formatToInplace, Append)
+{
+  inplace_string<16> key{"order:"};
+  format_append(key, "{}/{}", 12, "A");
+  EXPECT_EQ(key, "order:12/A");
+  EXPECT_THROW(format_append(key, "{:10}", 1), std::length_error);
+  EXPECT_THROW(format_to_inplace<4>("{}", 12345), std::length_error);
+}
+
+TEST(formatToInplace, MaxSize)
+{
+  constexpr format_string<inplace_string<8>, int> fmt{"{}:{:08}"};
+  static_assert(fmt.max_size() == 8 + 1 + 11);
+  static_assert(format_string<int, std::uint8_t>{"{:x}|{:b}"}.max_size() == 1 + 8 + 1 + 1 + 8);
+  static_assert(format_string<double, double>{"{}{:.3e}"}.max_size() == 24 + 1 + 3 + 1 + 1 + 5);
+  static_assert(format_string<int>{"{:30}"}.max_size() == 30);
+  static_assert(format_string<char[4], bool, char>{"{{{}{}{}}}"}.max_size() == 2 + 3 + 5 + 1);
+  static_assert(format_string<std::string_view>{"{}"}.max_size() == static_cast<std::size_t>(-1));
+  static_assert(format_string<double>{"{:.2f}"}.max_size() == static_cast<std::size_t>(-1));
+  EXPECT_EQ(format_to_inplace<fmt.max_size()>(fmt, inplace_string<8>{"12345678"}, -1), "12345678:-0000001");
+}
+
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L || defined(__GNUC__)
+
+namespace {
+  // true when the literal format parses in a constant expression for the given argument types
+  template<typename Literal, typename... Args>
+  constexpr auto parses(Literal, Args&&...)
+      -> decltype(std::integral_constant<std::size_t, basic_format_string<typename Literal::char_type,
+                                                                          std::decay_t<Args>...>{Literal::chars}
+                                                          .max_size()>{},
+                  true)
+  {
+    return true;
+  }
+  constexpr bool parses(...) { return false; }
+}
+
+TEST(formatToInplace, Literal)
+{
+  using namespace mp::literals;
+  const inplace_string<8> symbol{"MSFT"};
+  EXPECT_EQ(format_to_inplace<24>("{}:{:08}"_fmt, symbol, 1234), "MSFT:00001234");
+  EXPECT_EQ(format_to_inplace<16>("{{{:x}}}"_fmt, 255u), "{ff}");
+  EXPECT_EQ(format_to_inplace<16>(L"{}={:04}"_fmt, L"wide", 42), L"wide=0042");
+  EXPECT_EQ(format_to_inplace<4>("{}"_fmt, std::string_view{"abcd"}), "abcd");  // unbounded: checked at run time
+  EXPECT_THROW(format_to_inplace<4>("{}"_fmt, std::string_view{"abcde"}), std::length_error);
+
+  inplace_string<16> key{"id:"};
+  format_append(key, "{}/{}"_fmt, 'a', std::uint8_t{7});
+  EXPECT_EQ(key, "id:a/7");
+}
+
+TEST(formatToInplace, MalformedLiteral)
+{
+  using namespace mp::literals;
+  static_assert(parses("{}:{:08}"_fmt, 1, 2));
+  static_assert(!parses("{"_fmt, 1));
+  static_assert(!parses("}"_fmt, 1));
+  static_assert(!parses("{}{}"_fmt, 1));
+  static_assert(!parses("{0}"_fmt, 1));
+  static_assert(!parses("{:q}"_fmt, 1));
+  static_assert(!parses("{:+}"_fmt, "text"));
+  static_assert(!parses("{:.2}"_fmt, 1));
+  static_assert(!parses("{:.}"_fmt, 1.0));
+}
+
+#endif
+
+#if defined(MP_TEST_WITH_FMT)
+TEST(formatToInplace, FmtFormatter)
+{
+  EXPECT_EQ(fmt::format("[{:>6}]", inplace_string<8>{"abc"}), "[   abc]");
+}
+#endif
+
+#if defined(__cpp_lib_format)
+TEST(formatToInplace, StdFormatter)
+{
+  EXPECT_EQ(std::format("[{:<6}]", inplace_string<8>{"abc"}), "[abc   ]");
+}
+#endif
@@ -0,0 +1,144 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <mp/inplace_ids.h>
+#include <gtest/gtest.h>
+#include <cstring>
+#include <random>
+#include <string>
+#if __has_include(<arpa/inet.h>)
+#include <arpa/inet.h>
+#define MP_TEST_WITH_INET 1
+#endif
+
+using namespace mp;
+
+TEST(uuid, Format)
+{
+  static_assert(std::is_same_v<decltype(to_string(uuid{})), inplace_string<36>>);
+  EXPECT_EQ(to_string(uuid{}), "00000000-0000-0000-0000-000000000000");
+  const uuid id{{0x12, 0x3e, 0x45, 0x67, 0xe8, 0x9b, 0x12, 0xd3, 0xa4, 0x56, 0x42, 0x66, 0x14, 0x17, 0x40, 0x00}};
+  EXPECT_EQ(to_string(id), "123e4567-e89b-12d3-a456-426614174000");
+}
+
+TEST(uuid, Parse)
+{
+  const auto r = parse_uuid("123E4567-e89b-12d3-A456-426614174000");
+  ASSERT_TRUE(r);
+  EXPECT_EQ(to_string(r.value), "123e4567-e89b-12d3-a456-426614174000");
+  EXPECT_TRUE(parse_uuid(inplace_string<36>{"ffffffff-ffff-ffff-ffff-ffffffffffff"}));
+  EXPECT_EQ(parse_uuid("123e4567e89b12d3a456426614174000").status, parse_status::invalid);
+  EXPECT_EQ(parse_uuid("123e4567-e89b-12d3-a456-42661417400").status, parse_status::invalid);
+  EXPECT_EQ(parse_uuid("123e4567-e89b-12d3-a456_426614174000").status, parse_status::invalid);
+  EXPECT_EQ(parse_uuid("123e4567-e89b-12d3-a456-42661417400g").status, parse_status::invalid);
+  EXPECT_EQ(parse_uuid("g23e4567-e89b-12d3-a456-426614174000").status, parse_status::invalid);
+}
+
+TEST(ipv4, FormatAndParse)
+{
+  static_assert(std::is_same_v<decltype(to_string(ipv4_address{})), inplace_string<15>>);
+  EXPECT_EQ(to_string(ipv4_address{}), "0.0.0.0");
+  EXPECT_EQ(to_string(ipv4_address{{255, 255, 255, 255}}), "255.255.255.255");
+  EXPECT_EQ(to_string(ipv4_address{{192, 168, 1, 10}}), "192.168.1.10");
+  for(unsigned v = 0; v < 256; ++v) {
+    const ipv4_address addr{{std::uint8_t(v), std::uint8_t(255 - v), std::uint8_t(v / 3), std::uint8_t(v * 7)}};
+    const auto r = parse_ipv4(to_string(addr));
+    ASSERT_TRUE(r) << v;
+    ASSERT_EQ(r.value, addr) << v;
+  }
+  for(const char* text : {"", "1.2.3", "1.2.3.4.", ".1.2.3.4", "1..2.3", "256.1.1.1", "01.2.3.4", "1.2.3.4 ", "1.2.3.a",
+                          "1.2.3.1234", "1.2.3.-1", "1111.2.3.4"})
+    EXPECT_EQ(parse_ipv4(text).status, parse_status::invalid) << text;
+}
+
+TEST(ipv6, Format)
+{
+  static_assert(std::is_same_v<decltype(to_string(ipv6_address{})), inplace_string<45>>);
+  EXPECT_EQ(to_string(ipv6_address{}), "::");
+  EXPECT_EQ(to_string(ipv6_address{{0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1}}), "2001:db8::1");
+  EXPECT_EQ(to_string(ipv6_address{{0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1}}), "2001:db8:0:1::1");
+  EXPECT_EQ(to_string(ipv6_address{{0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 1}}), "2001:db8::1:0:0:1");
+  EXPECT_EQ(to_string(ipv6_address{{0x20, 0x01, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}}), "2001::");
+  EXPECT_EQ(to_string(ipv6_address{{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff, 192, 0, 2, 1}}), "::ffff:192.0.2.1");
+  EXPECT_EQ(to_string(ipv6_address{{0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                                    0xff, 0xff, 0xff}}),
+            "ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff");
+}
+
+TEST(ipv6, Parse)
+{
+  const auto r = parse_ipv6("2001:DB8::1");
+  ASSERT_TRUE(r);
+  EXPECT_EQ(to_string(r.value), "2001:db8::1");
+  EXPECT_EQ(to_string(parse_ipv6("0:0:0:0:0:ffff:192.0.2.1").value), "::ffff:192.0.2.1");
+  EXPECT_EQ(to_string(parse_ipv6("1::").value), "1::");
+  EXPECT_EQ(to_string(parse_ipv6("1:2:3:4:5:6:7::").value), "1:2:3:4:5:6:7:0");
+  EXPECT_EQ(to_string(parse_ipv6("::1:2:3:4:5:6:7").value), "0:1:2:3:4:5:6:7");
+  for(const char* text : {"", ":", ":::", "1:2", "1::2::3", ":1::2", "1::2:", "1:2:3:4:5:6:7:8:9", "12345::",
+                          "1:2:3:4:5:6:7:8::", "::1.2.3", "::1.2.3.04", "1:2:3:4:5:6:7:1.2.3.4", "g::"})
+    EXPECT_EQ(parse_ipv6(text).status, parse_status::invalid) << text;
+}
+
+#ifdef MP_TEST_WITH_INET
+
+TEST(ipv6, MatchesInet)
+{
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> word(0, 3);
+  for(int i = 0; i < 20000; ++i) {
+    // mostly zero or small groups to exercise "::" compression and the embedded IPv4 forms
+    ipv6_address addr;
+    for(std::size_t w = 0; w < 8; ++w) {
+      const int kind = word(gen);
+      const auto v = kind < 2 ? 0u : kind == 2 ? gen() % 16 : gen() & 0xFFFF;
+      addr.bytes[2 * w] = std::uint8_t(v >> 8);
+      addr.bytes[2 * w + 1] = std::uint8_t(v);
+    }
+    if(i % 7 == 0) addr.bytes[10] = addr.bytes[11] = 0xff;
+    char expected[INET6_ADDRSTRLEN];
+    ASSERT_NE(inet_ntop(AF_INET6, addr.bytes.data(), expected, sizeof(expected)), nullptr);
+    const auto text = to_string(addr);
+    ASSERT_EQ(text, expected);
+    const auto r = parse_ipv6(text);
+    ASSERT_TRUE(r) << expected;
+    ASSERT_EQ(r.value, addr) << expected;
+  }
+}
+
+TEST(ipv6, ParseMatchesInet)
+{
+  for(const char* text : {"::", "::1", "1::", "::ffff:1.2.3.4", "1:2:3:4:5:6:1.2.3.4", "::1.2.3.4", "1::1.2.3.4",
+                          "1:2:3:4:5:6:7:8", "01:002:0003:0004::", "1:2:3:4:5:6:7::", "1:2:3:4:5:6::1.2.3.4",
+                          "::1:2:3:4:5:6:1.2.3.4", "1:2:3:4:5:6:7:8:", ":1:2:3:4:5:6:7", "::00000", "1.2.3.4",
+                          "::256.1.1.1", "::1.2.3.4:1", "1:2:3:4:5:6:7:8:1.2.3.4", "abcd::ef01:1.2.3.4"}) {
+    unsigned char expected[16];
+    const bool ok = inet_pton(AF_INET6, text, expected) == 1;
+    const auto r = parse_ipv6(text);
+    ASSERT_EQ(static_cast<bool>(r), ok) << text;
+    if(ok) {
+      EXPECT_EQ(std::memcmp(r.value.bytes.data(), expected, 16), 0) << text;
+    }
+  }
+}
+
+#endif
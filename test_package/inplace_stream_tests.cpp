@@ -0,0 +1,110 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <mp/inplace_stream.h>
+#include <gtest/gtest.h>
+#include <iomanip>
+
+// explicit instantiation needed to make code coverage metrics work correctly
+template class mp::basic_inplace_stringbuf<char, 16, std::char_traits<char>>;
+template class mp::basic_inplace_ostream<char, 16, std::char_traits<char>>;
+
+using namespace mp;
+
+TEST(inplaceOstream, Format)
+{
+  inplace_ostream<32> os;
+  os << "id=" << 42 << ' ' << std::setw(6) << std::setfill('0') << std::fixed << std::setprecision(2) << 1.5;
+  EXPECT_TRUE(os.good());
+  EXPECT_EQ(os.view(), "id=42 001.50");
+  const inplace_string<32>& str = os.str();
+  EXPECT_EQ(str, "id=42 001.50");
+  EXPECT_EQ(str.size(), 12);
+  EXPECT_EQ(std::char_traits<char>::length(str.c_str()), 12);
+}
+
+TEST(inplaceOstream, Append)
+{
+  inplace_ostream<16> os{"abc"};
+  os << "def";
+  EXPECT_EQ(os.str(), "abcdef");
+  os << 'g';
+  EXPECT_EQ(os.str(), "abcdefg");
+  os.str("xy");
+  os << 1;
+  EXPECT_EQ(os.str(), "xy1");
+  EXPECT_THROW(os.str("12345678901234567"), std::length_error);
+}
+
+TEST(inplaceOstream, OverflowFail)
+{
+  inplace_ostream<8> os;
+  os << "1234567";
+  EXPECT_TRUE(os.good());
+  os << "89";
+  EXPECT_TRUE(os.fail());
+  EXPECT_FALSE(os.truncated());
+  EXPECT_EQ(os.str(), "12345678");
+
+  inplace_ostream<4> os2;
+  os2 << 'a' << 'b' << 'c' << 'd';
+  EXPECT_TRUE(os2.good());
+  os2 << 'e';
+  EXPECT_TRUE(os2.fail());
+  EXPECT_EQ(os2.str(), "abcd");
+}
+
+TEST(inplaceOstream, OverflowTruncate)
+{
+  inplace_ostream<8> os{inplace_overflow::truncate};
+  os << "12345" << 67890 << 'x';
+  EXPECT_TRUE(os.good());
+  EXPECT_TRUE(os.truncated());
+  EXPECT_EQ(os.str(), "12345678");
+  os.str("");
+  EXPECT_FALSE(os.truncated());
+  os << "ab";
+  EXPECT_EQ(os.str(), "ab");
+}
+
+TEST(inplaceOstream, Seek)
+{
+  inplace_ostream<16> os;
+  os << "hello world";
+  EXPECT_EQ(os.tellp(), 11);
+  os.seekp(0);
+  os << 'H';
+  EXPECT_EQ(os.str(), "Hello world");
+  os.seekp(0, std::ios_base::end);
+  os << '!';
+  EXPECT_EQ(os.str(), "Hello world!");
+  os.seekp(20);
+  EXPECT_TRUE(os.fail());
+}
+
+TEST(inplaceOstream, Wide)
+{
+  inplace_wostream<8> os;
+  os << L"x=" << 12;
+  EXPECT_EQ(os.str(), L"x=12");
+}
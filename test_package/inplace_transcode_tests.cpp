@@ -0,0 +1,194 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <mp/inplace_transcode.h>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace mp;
+
+namespace {
+
+  std::string utf8_of(const std::vector<char32_t>& cps)
+  {
+    std::string out;
+    for(const char32_t cp : cps) {
+      char buf[4];
+      out.append(buf, detail::encode_utf8(cp, buf));
+    }
+    return out;
+  }
+
+  std::u16string utf16_of(const std::vector<char32_t>& cps)
+  {
+    std::u16string out;
+    for(const char32_t cp : cps) {
+      if(cp < 0x10000)
+        out += static_cast<char16_t>(cp);
+      else {
+        out += static_cast<char16_t>(0xD800 + ((cp - 0x10000) >> 10));
+        out += static_cast<char16_t>(0xDC00 + ((cp - 0x10000) & 0x3FF));
+      }
+    }
+    return out;
+  }
+
+  template<typename CharT, std::size_t N, typename Traits>
+  std::basic_string<CharT> str(const basic_inplace_string<CharT, N, Traits>& s)
+  {
+    return {s.data(), s.size()};
+  }
+
+}
+
+TEST(transcode, Capacities)
+{
+  static_assert(std::is_same_v<decltype(to_utf16(inplace_string<40>{}).value), inplace_u16string<40>>);
+  static_assert(std::is_same_v<decltype(to_utf32(inplace_string<40>{}).value), inplace_u32string<40>>);
+  static_assert(std::is_same_v<decltype(to_utf8(inplace_u16string<40>{}).value), inplace_string<120>>);
+  static_assert(std::is_same_v<decltype(to_utf8(inplace_u32string<40>{}).value), inplace_string<160>>);
+  static_assert(std::is_same_v<decltype(to_utf8(inplace_u32string<100>{}).value), inplace_string<255>>);
+  static_assert(std::is_same_v<decltype(to_utf16(inplace_u32string<40>{}).value), inplace_u16string<80>>);
+  static_assert(std::is_same_v<decltype(to_utf32(inplace_u16string<40>{}).value), inplace_u32string<40>>);
+  static_assert(std::is_same_v<decltype(to_wide(inplace_string<40>{}).value), inplace_wstring<40>>);
+}
+
+TEST(transcode, KnownText)
+{
+  const inplace_string<32> text{"Gr\xc3\xbc\xc3\x9f \xe2\x82\xac \xf0\x9f\x98\x80!"};
+  const auto u16 = to_utf16(text);
+  ASSERT_TRUE(u16);
+  EXPECT_EQ(str(u16.value), u"Gr\u00fc\u00df \u20ac \U0001F600!");
+  const auto u32 = to_utf32(text);
+  ASSERT_TRUE(u32);
+  EXPECT_EQ(str(u32.value), U"Gr\u00fc\u00df \u20ac \U0001F600!");
+  EXPECT_EQ(str(to_utf8(u16.value).value), str(text));
+  EXPECT_EQ(str(to_utf8(u32.value).value), str(text));
+  EXPECT_EQ(str(to_utf32(u16.value).value), str(u32.value));
+  EXPECT_EQ(str(to_utf16(u32.value).value), str(u16.value));
+  const auto wide = to_wide(text);
+  ASSERT_TRUE(wide);
+  EXPECT_EQ(str(wide.value), L"Gr\u00fc\u00df \u20ac \U0001F600!");
+  EXPECT_EQ(str(to_utf8(wide.value).value), str(text));
+}
+
+TEST(transcode, RandomRoundTrips)
+{
+  std::mt19937 gen(3);
+  const char32_t samples[] = {U'a',   U'~',   0x7F,   0x80,    0xE9,    0x7FF,   0x800,   0x20AC,
+                              0xD7FF, 0xE000, 0xFFFD, 0xFFFF, 0x10000, 0x1F600, 0x10FFFF};
+  for(int i = 0; i < 5000; ++i) {
+    std::vector<char32_t> cps;
+    while(cps.size() < 60) {
+      // long ASCII runs take the SIMD paths, the rest the per code point ones
+      if(gen() % 3 == 0)
+        for(auto k = gen() % 40; k > 0; --k) cps.push_back(U'A' + static_cast<char32_t>(gen() % 26));
+      else
+        cps.push_back(samples[gen() % std::size(samples)]);
+    }
+    cps.resize(60);
+    const auto u8 = utf8_of(cps);
+    const auto u16 = utf16_of(cps);
+    const std::u32string u32(cps.begin(), cps.end());
+    if(u8.size() > 240) continue;
+
+    const inplace_string<240> s8(u8.data(), u8.size());
+    const inplace_u16string<120> s16(u16.data(), u16.size());
+    const inplace_u32string<60> s32(u32.data(), u32.size());
+    ASSERT_EQ(str(to_utf16(s8).value), u16) << i;
+    ASSERT_EQ(str(to_utf32(s8).value), u32) << i;
+    ASSERT_EQ(str(to_utf8(s16).value), u8) << i;
+    ASSERT_EQ(str(to_utf32(s16).value), u32) << i;
+    ASSERT_EQ(str(to_utf16(s32).value), u16) << i;
+    const auto back = to_utf8(s32);
+    ASSERT_TRUE(back) << i;
+    ASSERT_EQ(str(back.value), u8) << i;
+  }
+}
+
+TEST(transcode, AsciiRuns)
+{
+  for(std::size_t size = 0; size <= 64; ++size) {
+    std::string ascii;
+    for(std::size_t i = 0; i < size; ++i) ascii += static_cast<char>(' ' + i % 95);
+    const inplace_string<64> s8(ascii.data(), ascii.size());
+    const auto s16 = to_utf16(s8);
+    const auto s32 = to_utf32(s8);
+    ASSERT_EQ(str(s16.value), std::u16string(ascii.begin(), ascii.end())) << size;
+    ASSERT_EQ(str(s32.value), std::u32string(ascii.begin(), ascii.end())) << size;
+    ASSERT_EQ(str(to_utf8(s16.value).value), ascii) << size;
+    ASSERT_EQ(str(to_utf8(s32.value).value), ascii) << size;
+    ASSERT_EQ(str(to_utf16(s32.value).value), str(s16.value)) << size;
+    ASSERT_EQ(str(to_utf32(s16.value).value), str(s32.value)) << size;
+  }
+}
+
+TEST(transcode, Invalid)
+{
+  for(std::size_t pos = 0; pos < 40; pos += 3) {
+    inplace_string<40> s8(40, 'a');
+    s8[pos] = '\xc3';
+    EXPECT_EQ(to_utf16(s8).status, parse_status::invalid) << pos;
+    inplace_u16string<40> s16(40, u'a');
+    s16[pos] = 0xDC00;
+    EXPECT_EQ(to_utf8(s16).status, parse_status::invalid) << pos;
+    s16[pos] = 0xD800;
+    EXPECT_EQ(to_utf32(s16).status, parse_status::invalid) << pos;
+    inplace_u32string<40> s32(40, U'a');
+    s32[pos] = 0x110000;
+    EXPECT_EQ(to_utf16(s32).status, parse_status::invalid) << pos;
+    s32[pos] = 0xDFFF;
+    EXPECT_EQ(to_utf8(s32).status, parse_status::invalid) << pos;
+    s32[pos] = 0x80000041;
+    EXPECT_EQ(to_utf16(s32).status, parse_status::invalid) << pos;
+  }
+}
+
+TEST(transcode, Append)
+{
+  inplace_string<8> out{"ab"};
+  EXPECT_EQ(transcode_append(out, std::u16string_view{u"\u20ac"}), parse_status::ok);
+  EXPECT_EQ(out, "ab\xe2\x82\xac");
+  EXPECT_EQ(transcode_append(out, std::u32string_view{U"\U0001F600"}), parse_status::out_of_range);
+  EXPECT_EQ(transcode_append(out, std::u16string_view{u"xy\xd800"}), parse_status::invalid);
+  EXPECT_EQ(out, "ab\xe2\x82\xac");
+  EXPECT_STREQ(out.c_str(), "ab\xe2\x82\xac");
+  EXPECT_EQ(to_utf8(inplace_u16string<100>(100, u'\u20ac')).status, parse_status::out_of_range);
+}
+
+TEST(transcode, FailedAppendKeepsTerminator)
+{
+  inplace_string<16> out{"ab"};
+  EXPECT_EQ(transcode_append(out, std::u16string_view{u"cdef\xd800"}), parse_status::invalid);
+  EXPECT_EQ(2u, out.size());
+  EXPECT_STREQ("ab", out.c_str());
+  EXPECT_EQ(transcode_append(out, std::u32string_view{U"0123456789abcdef"}), parse_status::out_of_range);
+  EXPECT_EQ(2u, out.size());
+  EXPECT_STREQ("ab", out.c_str());
+
+  inplace_u16string<4> wide{u"a"};
+  EXPECT_EQ(transcode_append(wide, std::string_view{"bc\xff"}), parse_status::invalid);
+  EXPECT_EQ(std::u16string_view{u"a"}, std::u16string_view{wide.c_str()});
+}
@@ -0,0 +1,108 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <mp/packed_inplace_string.h>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+// explicit instantiation needed to make code coverage metrics work correctly
+template class mp::packed_inplace_string<16, mp::symbol_alphabet>;
+
+using namespace mp;
+
+TEST(packedInplaceString, CompileTime)
+{
+  static_assert(packed_inplace_string<10>::bits_per_char == 6, "");
+  static_assert(sizeof(packed_inplace_string<10>) == 8, "");
+  static_assert(sizeof(packed_inplace_string<20>) == 16, "");
+  static_assert(packed_inplace_string<12, upper_alphabet>::bits_per_char == 5, "");
+  static_assert(sizeof(packed_inplace_string<12, upper_alphabet>) == 8, "");
+
+  constexpr packed_inplace_string<12> sym{"BRK.B"};
+  static_assert(sym.size() == 5, "");
+  static_assert(sym[3] == '.', "");
+  static_assert(sym.unpack() == "BRK.B", "");
+  static_assert(packed_inplace_string<12>{"AB"} < packed_inplace_string<12>{"ABC"}, "");
+}
+
+TEST(packedInplaceString, Assign)
+{
+  packed_inplace_string<12> str;
+  EXPECT_TRUE(str.empty());
+  EXPECT_EQ(0u, str.size());
+  str = "EUR-USD_2024";
+  EXPECT_FALSE(str.empty());
+  EXPECT_EQ(12u, str.size());
+  EXPECT_EQ("EUR-USD_2024", str.unpack());
+  inplace_string<12> unpacked = str;
+  EXPECT_EQ("EUR-USD_2024", unpacked);
+  str = "X";
+  EXPECT_EQ(1u, str.size());
+  EXPECT_EQ("X", str.unpack());
+  EXPECT_THROW(str.assign("lowercase"), std::invalid_argument);
+  EXPECT_THROW(str.assign("ABCDEFGHIJKLM"), std::length_error);
+  EXPECT_TRUE(packed_inplace_string<12>::contains('_'));
+  EXPECT_FALSE(packed_inplace_string<12>::contains(' '));
+}
+
+TEST(packedInplaceString, SizeAtWordBoundaries)
+{
+  const std::string text = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123";
+  for(std::size_t n = 0; n <= text.size(); ++n) {
+    packed_inplace_string<30> str{std::string_view{text}.substr(0, n)};
+    EXPECT_EQ(n, str.size());
+    EXPECT_EQ(std::string_view{text}.substr(0, n), std::string_view{str.unpack()});
+  }
+}
+
+TEST(packedInplaceString, Ordering)
+{
+  const char* samples[] = {"", "-", ".", "0", "9", "A", "AA", "AB", "A_", "B", "Z", "_", "ZZZZZZZZZZZZ", "ZZZZZZZZZZZ"};
+  for(const char* a : samples)
+    for(const char* b : samples) {
+      const std::string_view sa{a}, sb{b};
+      const packed_inplace_string<12> pa{a}, pb{b};
+      EXPECT_EQ(sa == sb, pa == pb) << a << " == " << b;
+      EXPECT_EQ(sa < sb, pa < pb) << a << " < " << b;
+      if(sa == sb) {
+        EXPECT_EQ(std::hash<packed_inplace_string<12>>{}(pa), std::hash<packed_inplace_string<12>>{}(pb));
+      }
+    }
+}
+
+TEST(packedInplaceString, Output)
+{
+  std::ostringstream os;
+  os << packed_inplace_string<8, upper_alphabet>{"ABC._-"};
+  EXPECT_EQ("ABC._-", os.str());
+}
+
+#if !defined(NDEBUG)
+TEST(packedInplaceString, IndexOutOfRange)
+{
+  // 13 characters of 6 bits take two words with room for 20
+  const packed_inplace_string<13> str{"ABC"};
+  EXPECT_EQ('\0', str[12]);
+  EXPECT_DEATH(str[13], "pos < MaxSize");
+}
+#endif
@@ -0,0 +1,76 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <mp/perfect_hash_switch.h>
+#include <gtest/gtest.h>
+#include <string>
+
+// explicit instantiation needed to make code coverage metrics work correctly
+template class mp::basic_perfect_hash_switch<char, 3, 8, std::char_traits<char>>;
+
+using namespace mp;
+
+namespace {
+  enum class msg_type { add, cancel, modify, trade, unknown };
+  constexpr auto msg_switch = make_perfect_hash_switch("ADD", "CANCEL", "MODIFY", "TRADE");
+
+  constexpr auto fields = make_perfect_hash_switch(
+      "Account", "AvgPx", "ClOrdID", "CumQty", "Currency", "ExecID", "ExecTransType", "HandlInst", "SecurityIDSource",
+      "LastPx", "LastQty", "MsgSeqNum", "MsgType", "OrderID", "OrderQty", "OrdStatus", "OrdType", "OrigClOrdID",
+      "Price", "SecurityID", "SenderCompID", "SendingTime", "Side", "Symbol", "TargetCompID", "Text", "TimeInForce",
+      "TransactTime", "SettlType", "SettlDate", "Commission", "ExecType", "LeavesQty", "MinQty", "MaxFloor");
+}
+
+TEST(perfectHashSwitch, CompileTime)
+{
+  static_assert(msg_switch.size() == 4, "");
+  static_assert(msg_switch.find(std::string_view{"ADD"}) == 0, "");
+  static_assert(msg_switch.find(std::string_view{"TRADE"}) == 3, "");
+  static_assert(msg_switch.find(std::string_view{"TRAD"}) == msg_switch.npos, "");
+  static_assert(msg_switch.find(inplace_string<8>{"MODIFY"}, msg_type::unknown) == msg_type::modify, "");
+}
+
+TEST(perfectHashSwitch, Find)
+{
+  EXPECT_EQ(1u, msg_switch.find(inplace_string<16>{"CANCEL"}));
+  EXPECT_EQ(msg_type::cancel, msg_switch.find(std::string{"CANCEL"}, msg_type::unknown));
+  EXPECT_EQ(msg_type::unknown, msg_switch.find(std::string{"CANCELLED"}, msg_type::unknown));
+  EXPECT_EQ(msg_switch.npos, msg_switch.find(std::string_view{""}));
+  EXPECT_EQ(msg_switch.npos, msg_switch.find(std::string_view{"add"}));
+}
+
+TEST(perfectHashSwitch, AllKeys)
+{
+  for(std::size_t i = 0; i < fields.size(); ++i) {
+    EXPECT_EQ(i, fields.find(fields[i]));
+    inplace_string<32> other{fields[i]};
+    other.push_back('x');
+    EXPECT_EQ(fields.npos, fields.find(other));
+  }
+}
+
+TEST(perfectHashSwitch, SingleKey)
+{
+  constexpr auto single = make_perfect_hash_switch("X");
+  static_assert(single.find(std::string_view{"X"}) == 0, "");
+  EXPECT_EQ(single.npos, single.find(std::string_view{"Y"}));
+}
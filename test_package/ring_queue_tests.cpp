@@ -0,0 +1,163 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <mp/ring_queue.h>
+#include <mp/inplace_string.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+// explicit instantiation needed to make code coverage metrics work correctly
+template class mp::spsc_ring_queue<mp::inplace_string<31>, 8>;
+template class mp::mpmc_ring_queue<mp::inplace_string<31>, 8>;
+
+using namespace mp;
+
+namespace {
+  struct log_record {
+    int level = 0;
+    inplace_string<15> source;
+    inplace_string<47> text;
+  };
+}
+
+TEST(spscRingQueue, InPlace)
+{
+  spsc_ring_queue<inplace_string<31>, 4> queue;
+  EXPECT_TRUE(queue.empty());
+  EXPECT_TRUE(queue.try_emplace("abc"));
+  EXPECT_TRUE(queue.try_emplace(3, 'x'));
+  EXPECT_TRUE(queue.try_write([](inplace_string<31>& slot) {
+    slot.assign("key:");
+    slot.append("value");
+  }));
+  EXPECT_TRUE(queue.try_emplace(inplace_string<31>{"last"}));
+  EXPECT_FALSE(queue.try_emplace("full"));
+
+  EXPECT_TRUE(queue.try_read([](const inplace_string<31>& slot) { EXPECT_EQ("abc", slot); }));
+  inplace_string<31> value;
+  EXPECT_TRUE(queue.try_pop(value));
+  EXPECT_EQ("xxx", value);
+  EXPECT_TRUE(queue.try_pop(value));
+  EXPECT_EQ("key:value", value);
+  EXPECT_TRUE(queue.try_pop(value));
+  EXPECT_EQ("last", value);
+  EXPECT_FALSE(queue.try_pop(value));
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(spscRingQueue, Records)
+{
+  spsc_ring_queue<log_record, 2> queue;
+  EXPECT_TRUE(queue.try_write([](log_record& r) {
+    r.level = 3;
+    r.source = "feed";
+    r.text.assign("connected to ").append("XNAS");
+  }));
+  EXPECT_TRUE(queue.try_read([](const log_record& r) {
+    EXPECT_EQ(3, r.level);
+    EXPECT_EQ("feed", r.source);
+    EXPECT_EQ("connected to XNAS", r.text);
+  }));
+}
+
+TEST(spscRingQueue, Concurrent)
+{
+  constexpr int count = 100000;
+  spsc_ring_queue<inplace_string<15>, 64> queue;
+  std::thread producer{[&] {
+    for(int i = 0; i < count; ++i)
+      while(!queue.try_emplace(std::to_string(i).c_str())) std::this_thread::yield();
+  }};
+  for(int i = 0; i < count; ++i) {
+    inplace_string<15> value;
+    while(!queue.try_pop(value)) std::this_thread::yield();
+    ASSERT_EQ(std::to_string(i).c_str(), value);
+  }
+  producer.join();
+}
+
+TEST(mpmcRingQueue, InPlace)
+{
+  mpmc_ring_queue<inplace_string<31>, 2> queue;
+  EXPECT_TRUE(queue.try_emplace("abc"));
+  EXPECT_TRUE(queue.try_emplace("def", 2));
+  EXPECT_FALSE(queue.try_emplace("full"));
+  EXPECT_TRUE(queue.try_read([](const inplace_string<31>& slot) { EXPECT_EQ("abc", slot); }));
+  inplace_string<31> value;
+  EXPECT_TRUE(queue.try_pop(value));
+  EXPECT_EQ("de", value);
+  EXPECT_FALSE(queue.try_pop(value));
+}
+
+TEST(mpmcRingQueue, ThrowingOperation)
+{
+  mpmc_ring_queue<inplace_string<4>, 2> queue;
+  for(int lap = 0; lap < 3; ++lap) {
+    EXPECT_THROW(queue.try_write([](inplace_string<4>& slot) { slot.assign("ab").append("xyz"); }), std::length_error);
+    EXPECT_TRUE(queue.try_emplace("ok"));
+    inplace_string<4> value;
+    EXPECT_TRUE(queue.try_pop(value));
+    EXPECT_EQ("ok", value);
+    EXPECT_FALSE(queue.try_pop(value));
+  }
+
+  EXPECT_TRUE(queue.try_emplace("a"));
+  EXPECT_TRUE(queue.try_emplace("b"));
+  EXPECT_THROW(queue.try_read([](const inplace_string<4>&) { throw std::runtime_error("consumer failed"); }),
+               std::runtime_error);
+  inplace_string<4> value;
+  EXPECT_TRUE(queue.try_pop(value));
+  EXPECT_EQ("b", value);
+  EXPECT_TRUE(queue.try_emplace("c"));
+  EXPECT_TRUE(queue.try_emplace("d"));
+  EXPECT_FALSE(queue.try_emplace("e"));
+}
+
+TEST(mpmcRingQueue, Concurrent)
+{
+  constexpr int producers = 3;
+  constexpr int consumers = 3;
+  constexpr int count = 30000;
+  mpmc_ring_queue<inplace_string<15>, 64> queue;
+  std::atomic<long long> sum{0};
+  std::atomic<int> consumed{0};
+
+  std::vector<std::thread> threads;
+  for(int p = 0; p < producers; ++p)
+    threads.emplace_back([&] {
+      for(int i = 1; i <= count; ++i)
+        while(!queue.try_emplace(std::to_string(i).c_str())) std::this_thread::yield();
+    });
+  for(int c = 0; c < consumers; ++c)
+    threads.emplace_back([&] {
+      while(consumed.load() < producers * count) {
+        if(queue.try_read([&](const inplace_string<15>& s) { sum += std::stoll(s.c_str()); }))
+          ++consumed;
+        else
+          std::this_thread::yield();
+      }
+    });
+  for(auto& t : threads) t.join();
+  EXPECT_EQ(static_cast<long long>(producers) * count * (count + 1) / 2, sum.load());
+}
@@ -0,0 +1,74 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <mp/seqlock_inplace_string.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// explicit instantiation needed to make code coverage metrics work correctly
+template class mp::basic_seqlock_inplace_string<char, 31, std::char_traits<char>>;
+
+using namespace mp;
+
+TEST(seqlockInplaceString, CompileTime) { static_assert(alignof(seqlock_inplace_string<15>) == 64, ""); }
+
+TEST(seqlockInplaceString, StoreLoad)
+{
+  seqlock_inplace_string<16> str;
+  EXPECT_TRUE(str.load().empty());
+  str.store(inplace_string<16>{"ACTIVE"});
+  EXPECT_EQ("ACTIVE", str.load());
+  inplace_string<16> value;
+  EXPECT_TRUE(str.try_load(value));
+  EXPECT_EQ("ACTIVE", value);
+  str.update([](inplace_string<16>& s) { s += "_HALTED"; });
+  EXPECT_EQ("ACTIVE_HALTED", static_cast<inplace_string<16>>(str));
+}
+
+TEST(seqlockInplaceString, ConcurrentReaders)
+{
+  seqlock_inplace_string<31> shared{inplace_string<31>{"a"}};
+  std::atomic<bool> done{false};
+
+  std::vector<std::thread> readers;
+  std::atomic<int> torn{0};
+  for(int i = 0; i < 4; ++i)
+    readers.emplace_back([&] {
+      while(!done.load(std::memory_order_relaxed)) {
+        const auto s = shared.load();
+        // every published value consists of one repeated letter whose count matches the letter
+        if(s.empty() || s.size() != static_cast<std::size_t>(s[0] - 'a' + 1) ||
+           std::count(s.begin(), s.end(), s[0]) != static_cast<std::ptrdiff_t>(s.size()))
+          ++torn;
+      }
+    });
+
+  for(int i = 0; i < 100000; ++i) {
+    const auto len = static_cast<std::size_t>(i % 26 + 1);
+    shared.store(inplace_string<31>(len, static_cast<char>('a' + len - 1)));
+  }
+  done = true;
+  for(auto& t : readers) t.join();
+  EXPECT_EQ(0, torn.load());
+}
@@ -0,0 +1,158 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <mp/shm_ring.h>
+#include <mp/inplace_string.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <sys/wait.h>
+
+using namespace mp;
+
+namespace {
+  struct quote {
+    inplace_string<15> symbol;
+    inplace_string<7> venue;
+    std::int64_t price;
+  };
+
+  std::string ring_name(const char* test) { return "/mp_shm_ring_" + std::string(test) + std::to_string(::getpid()); }
+
+  struct ring_guard {
+    std::string name;
+    ~ring_guard() { shm_ring_writer<quote, 16>::unlink(name); }
+  };
+}
+
+TEST(shmRing, WriteRead)
+{
+  ring_guard guard{ring_name("WriteRead")};
+  shm_ring_writer<quote, 16> writer{guard.name};
+  shm_ring_reader<quote, 16> reader{guard.name};
+  EXPECT_EQ(shm_read_status::empty, reader.try_read([](const quote&) {}));
+
+  writer.write([](quote& q) {
+    q.symbol = "AAPL";
+    q.venue = "XNAS";
+    q.price = 1234;
+  });
+  EXPECT_EQ(shm_read_status::ok, reader.try_read([](const quote& q) {
+    EXPECT_EQ("AAPL", q.symbol);
+    EXPECT_EQ("XNAS", q.venue);
+    EXPECT_EQ(1234, q.price);
+  }));
+  EXPECT_EQ(shm_read_status::empty, reader.try_read([](const quote&) {}));
+}
+
+TEST(shmRing, Overrun)
+{
+  ring_guard guard{ring_name("Overrun")};
+  shm_ring_writer<quote, 16> writer{guard.name};
+  shm_ring_reader<quote, 16> reader{guard.name};
+  for(int i = 0; i < 40; ++i) writer.push(quote{inplace_string<15>{"S"}, inplace_string<7>{"V"}, i});
+
+  quote q;
+  EXPECT_EQ(shm_read_status::overrun, reader.try_pop(q));
+  EXPECT_EQ(25u, reader.lost());
+  EXPECT_EQ(shm_read_status::ok, reader.try_pop(q));
+  EXPECT_EQ(25, q.price);
+}
+
+TEST(shmRing, WriterRestart)
+{
+  ring_guard guard{ring_name("WriterRestart")};
+  {
+    shm_ring_writer<quote, 16> writer{guard.name};
+    writer.push(quote{inplace_string<15>{"A"}, inplace_string<7>{"V"}, 1});
+  }
+  shm_ring_reader<quote, 16> reader{guard.name, shm_ring_reader<quote, 16>::start::oldest};
+  shm_ring_writer<quote, 16> writer{guard.name};
+  EXPECT_EQ(1u, writer.cursor());
+  writer.push(quote{inplace_string<15>{"B"}, inplace_string<7>{"V"}, 2});
+  quote q;
+  EXPECT_EQ(shm_read_status::ok, reader.try_pop(q));
+  EXPECT_EQ("A", q.symbol);
+  EXPECT_EQ(shm_read_status::ok, reader.try_pop(q));
+  EXPECT_EQ("B", q.symbol);
+}
+
+TEST(shmRing, CrossProcess)
+{
+  ring_guard guard{ring_name("CrossProcess")};
+  constexpr int count = 10000;
+  shm_ring_writer<quote, 16>{guard.name};  // create the segment before forking
+  shm_ring_reader<quote, 16> reader{guard.name};
+
+  const pid_t pid = ::fork();
+  ASSERT_NE(-1, pid);
+  if(pid == 0) {
+    shm_ring_writer<quote, 16> writer{guard.name};
+    for(int i = 0; i < count; ++i) {
+      writer.write([&](quote& q) {
+        q.symbol.assign(std::to_string(i).c_str());
+        q.venue = "XNAS";
+        q.price = i;
+      });
+      if(i % 8 == 0) ::usleep(10);  // the reader is not expected to keep up otherwise
+    }
+    ::_exit(0);
+  }
+
+  int received = 0;
+  std::int64_t last = -1;
+  bool ordered = true;
+  int status = 0;
+  bool exited = false;
+  while(received + static_cast<int>(reader.lost()) < count) {
+    quote q;
+    const auto result = reader.try_pop(q);
+    if(result == shm_read_status::ok) {
+      ordered = ordered && q.price > last && q.symbol == std::to_string(q.price).c_str();
+      last = q.price;
+      ++received;
+    }
+    else if(result == shm_read_status::empty) {
+      // stop once the writer is gone and everything it published has been read
+      if(exited) break;
+      exited = ::waitpid(pid, &status, WNOHANG) == pid;
+    }
+  }
+  if(!exited) ::waitpid(pid, &status, 0);
+  EXPECT_TRUE(WIFEXITED(status));
+  EXPECT_TRUE(ordered);
+  EXPECT_EQ(count, received + static_cast<int>(reader.lost()));
+}
+
+TEST(shmRing, WriterLayoutMismatch)
+{
+  ring_guard guard{ring_name("WriterLayoutMismatch")};
+  shm_ring_writer<quote, 16> writer{guard.name};
+  writer.push(quote{inplace_string<15>{"A"}, inplace_string<7>{"V"}, 1});
+  shm_ring_reader<quote, 16> reader{guard.name, shm_ring_reader<quote, 16>::start::oldest};
+
+  EXPECT_THROW((shm_ring_writer<quote, 4>{guard.name}), std::runtime_error);
+  EXPECT_THROW((shm_ring_writer<std::int64_t, 16>{guard.name}), std::runtime_error);
+  // the segment kept its size, so the mapped reader still works
+  quote q;
+  EXPECT_EQ(shm_read_status::ok, reader.try_pop(q));
+  EXPECT_EQ("A", q.symbol);
+}
@@ -0,0 +1,89 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// built as a separate executable as MP_INPLACE_STRING_TELEMETRY must be defined in all translation units
+#include <mp/inplace_string.h>
+#include <gtest/gtest.h>
+#include <sstream>
+
+#if !defined(MP_INPLACE_STRING_TELEMETRY)
+#error "MP_INPLACE_STRING_TELEMETRY must be defined for this test"
+#endif
+
+using namespace mp;
+
+TEST(inplaceStringTelemetry, SizeHistogram)
+{
+  const auto& stats = inplace_string_telemetry<inplace_string<10>>();
+  const auto updates = stats.size_updates();
+  inplace_string<10> str{"abc"};  // 30%
+  str.append("defgh");              // 80%
+  str.push_back('i');               // not recorded
+  str.clear();                      // not recorded
+  str.resize(9, 'x');               // 90% - near overflow
+  EXPECT_EQ(updates + 3, stats.size_updates());
+  EXPECT_EQ(1u, stats.histogram(3));
+  EXPECT_EQ(1u, stats.histogram(8));
+  EXPECT_EQ(1u, stats.histogram(9));
+  EXPECT_EQ(1u, stats.near_overflow());
+  EXPECT_EQ(9u, stats.max_seen());
+  EXPECT_EQ(18u, stats.bytes_copied());
+  EXPECT_EQ(10u, stats.max_size());
+}
+
+TEST(inplaceStringTelemetry, IntermediateSizesAreNotRecorded)
+{
+  const auto& stats = inplace_string_telemetry<inplace_string<20>>();
+  inplace_string<20> str;
+  for(char c : {'a', 'b', 'c'}) str.push_back(c);
+  str.clear();
+  EXPECT_EQ(0u, stats.size_updates());
+  str.append_uint(12345u);
+  EXPECT_EQ(1u, stats.size_updates());
+  EXPECT_EQ(1u, stats.histogram(2));
+}
+
+TEST(inplaceStringTelemetry, Overflow)
+{
+  const auto& stats = inplace_string_telemetry<inplace_string<4>>();
+  inplace_string<4> str{"abcd"};
+  EXPECT_THROW(str.push_back('e'), std::length_error);
+  EXPECT_THROW(str.append_uninitialized(1), std::length_error);
+  EXPECT_EQ(2u, stats.overflow());
+  EXPECT_EQ(1u, stats.histogram(10));
+}
+
+TEST(inplaceStringTelemetry, ConstantEvaluationIsNotRecorded)
+{
+  constexpr inplace_string<6> str{"abc"};
+  static_assert(str.size() == 3, "");
+  EXPECT_EQ(0u, inplace_string_telemetry<inplace_string<6>>().size_updates());
+}
+
+TEST(inplaceStringTelemetry, Dump)
+{
+  inplace_wstring<12> str{L"abc"};
+  std::ostringstream os;
+  dump_inplace_string_telemetry(os);
+  EXPECT_NE(std::string::npos, os.str().find("basic_inplace_string<" + std::to_string(sizeof(wchar_t)) +
+                                             "-byte char, 12>: updates=1"));
+}
@@ -22,6 +22,9 @@
 
 #include <mp/inplace_string.h>
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
 
 // explicit instantiation needed to make code coverage metrics work correctly
 template class mp::basic_inplace_string<char, 16, std::char_traits<char>>;
@@ -42,6 +45,138 @@ TEST(inPlaceString, DefaultConstructor)
   EXPECT_EQ(std::begin(str), std::end(str));
 }
 
+TEST(inPlaceString, ConstexprDefault)
+{
+  constexpr inplace_string<8> str;
+  static_assert(str.empty(), "");
+  static_assert(str.size() == 0, "");
+  static_assert(str == "", "");
+}
+
+namespace {
+  constexpr inplace_string<16> make_key()
+  {
+    inplace_string<16> str{"abc"};
+    str += ':';
+    str.append("def");
+    str.push_back('!');
+    str += std::string_view{"gh"};
+    str.resize(11, '$');
+    return str;
+  }
+}
+
+TEST(inPlaceString, ConstexprModifiers)
+{
+  constexpr auto str = make_key();
+  static_assert(str.size() == 11, "");
+  static_assert(str == "abc:def!gh$", "");
+  static_assert(str != "abc", "");
+  static_assert("abc" < str, "");
+  static_assert(str > inplace_string<16>{"abc"}, "");
+  static_assert(str.back() == '$', "");
+  EXPECT_EQ("abc:def!gh$", str);
+}
+
+TEST(inPlaceString, ConstexprSwap)
+{
+  constexpr auto swapped = [] {
+    inplace_string<8> a{"abc"};
+    inplace_string<8> b{"defgh"};
+    a.swap(b);
+    return a;
+  }();
+  static_assert(swapped == "defgh", "");
+}
+
+TEST(inPlaceString, ConstexprTable)
+{
+  static constexpr inplace_string<4> table[] = {"USD", "EUR", "GBP", "JPY"};
+  static_assert(table[2] == "GBP", "");
+  static_assert(table[0] > table[1], "");
+  EXPECT_STREQ("JPY", table[3].c_str());
+}
+
+TEST(inPlaceString, DeductionGuide)
+{
+  constexpr basic_inplace_string str = "ABC";
+  static_assert(std::is_same_v<std::remove_cv_t<decltype(str)>, inplace_string<3>>, "");
+  static_assert(str.size() == 3, "");
+  EXPECT_EQ("ABC", str);
+}
+
+#if(defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L) || defined(__GNUC__)
+TEST(inPlaceString, Literal)
+{
+  constexpr auto str = "ABC"_is;
+  static_assert(std::is_same_v<std::remove_cv_t<decltype(str)>, inplace_string<3>>, "");
+  static_assert(str == "ABC", "");
+  constexpr auto wstr = L"ABCD"_is;
+  static_assert(std::is_same_v<std::remove_cv_t<decltype(wstr)>, inplace_wstring<4>>, "");
+  static_assert(wstr.size() == 4, "");
+  constexpr auto nul = "a\0b"_is;
+  static_assert(nul.size() == 3, "");
+  EXPECT_EQ("ABC", str);
+}
+#endif
+
+TEST(inPlaceString, UnicodeAliases)
+{
+  static_assert(sizeof(inplace_u16string<8>) == 9 * sizeof(char16_t), "");
+  static_assert(sizeof(inplace_u32string<8>) == 9 * sizeof(char32_t), "");
+  static_assert(inplace_u16string<1000>{}.max_size() == 1000, "");
+  constexpr inplace_u16string<8> u16{u"Zo\u00eb"};
+  static_assert(u16.size() == 3 && u16[2] == u'\u00eb', "");
+  inplace_u32string<8> u32{U"\U0001F600"};
+  u32 += U'!';
+  EXPECT_EQ(u32, U"\U0001F600!");
+  EXPECT_EQ(std::hash<inplace_u32string<8>>{}(u32), std::hash<std::u32string_view>{}(U"\U0001F600!"));
+#if defined(__cpp_char8_t)
+  const inplace_u8string<8> u8{u8"\u00e9"};
+  EXPECT_EQ(u8.size(), 2u);
+#endif
+}
+
+TEST(inPlaceString, Concatenation1)
+{
+  const inplace_string<8> exchange{"XNAS"};
+  const inplace_string<16> symbol{"AAPL"};
+  inplace_string<25> key = exchange + ':' + symbol;
+  EXPECT_EQ(9u, key.size());
+  EXPECT_STREQ("XNAS:AAPL", key.c_str());
+  EXPECT_EQ("XNAS:AAPL", key);
+}
+
+TEST(inPlaceString, Concatenation2)
+{
+  const inplace_string<4> a{"ab"};
+  const inplace_string<4> b{"cd"};
+  const inplace_string<4> c{"ef"};
+  basic_inplace_string str = a + b + "lit" + c;
+  static_assert(std::is_same_v<decltype(str), inplace_string<15>>, "");
+  EXPECT_EQ(9u, str.size());
+  EXPECT_EQ("abcdlitef", str);
+}
+
+TEST(inPlaceString, Concatenation3)
+{
+  const inplace_string<4> a{"ab"};
+  basic_inplace_string str = "<" + a + '>';
+  static_assert(std::is_same_v<decltype(str), inplace_string<6>>, "");
+  EXPECT_EQ("<ab>", str);
+  inplace_string<32> big;
+  big = '[' + ("x" + a) + (a + a) + ']';
+  EXPECT_EQ("[xababab]", big);
+}
+
+TEST(inPlaceString, Concatenation4)
+{
+  constexpr inplace_string<4> a{"ab"};
+  constexpr inplace_string<8> str = a + "cd" + 'e';
+  static_assert(str == "abcde", "");
+  EXPECT_EQ("abcde", str);
+}
+
 TEST(inPlaceString, UserConstructorPos1)
 {
   inplace_string<8> txt{"abcdefgh"};
@@ -890,6 +1025,62 @@ TEST(inPlaceString, ResizeN1)
   EXPECT_EQ(5, std::distance(std::begin(str), std::end(str)));
 }
 
+TEST(inPlaceString, ResizeAndOverwrite1)
+{
+  inplace_string<16> str{"abc"};
+  str.resize_and_overwrite(8, [](char* p, std::size_t n) {
+    EXPECT_EQ(8u, n);
+    EXPECT_EQ('a', p[0]);
+    p[3] = 'd';
+    p[4] = 'e';
+    return 5;
+  });
+  EXPECT_EQ(5u, str.size());
+  EXPECT_STREQ("abcde", str.c_str());
+  EXPECT_EQ("abcde", str);
+}
+
+TEST(inPlaceString, ResizeAndOverwrite2)
+{
+  inplace_string<8> str{"abc"};
+  str.resize_and_overwrite(8, [](char* p, std::size_t n) {
+    std::fill(p, p + n, '$');
+    return n;
+  });
+  EXPECT_EQ(8u, str.size());
+  EXPECT_STREQ("$$$$$$$$", str.c_str());
+}
+
+TEST(inPlaceString, ResizeAndOverwrite3)
+{
+  inplace_string<8> str{"abc"};
+  EXPECT_THROW(str.resize_and_overwrite(9, [](char*, std::size_t n) { return n; }), std::length_error);
+  EXPECT_EQ("abc", str);
+}
+
+TEST(inPlaceString, AppendUninitialized1)
+{
+  inplace_string<16> str{"abc"};
+  char* p = str.append_uninitialized(4);
+  EXPECT_EQ(str.data() + 3, p);
+  EXPECT_EQ(3u, str.size());
+  p[0] = 'd';
+  p[1] = 'e';
+  str.commit(2);
+  EXPECT_EQ(5u, str.size());
+  EXPECT_STREQ("abcde", str.c_str());
+  EXPECT_EQ("abcde", str);
+}
+
+TEST(inPlaceString, AppendUninitialized2)
+{
+  inplace_string<4> str{"abc"};
+  EXPECT_THROW(str.append_uninitialized(2), std::length_error);
+  *str.append_uninitialized(1) = 'd';
+  str.commit(1);
+  EXPECT_EQ("abcd", str);
+}
+
 TEST(inPlaceString, Clear1)
 {
   inplace_string<16> str{"test"};
@@ -1080,6 +1271,365 @@ TEST(inPlaceString, AppendOtherPosN2)
   EXPECT_EQ(8, std::distance(std::begin(str), std::end(str)));
 }
 
+TEST(inPlaceString, PushBack1)
+{
+  inplace_string<3> str;
+  str.push_back('a');
+  str.push_back('b');
+  str.push_back('c');
+  EXPECT_EQ(3u, str.size());
+  EXPECT_STREQ("abc", str.c_str());
+  EXPECT_THROW(str.push_back('d'), std::length_error);
+}
+
+namespace {
+  template<std::size_t MaxSize>
+  void check_word_sized_operations()
+  {
+    // leftovers of longer strings must not affect the results
+    const char* samples[] = {"", "A", "AB", "ABC", "ABD", "AB\xFF", "abcdefg", "abcdefh", "abcdef",
+                             "ABCDEFGHIJKLMNO", "ABCDEFGHIJKLMN", "ABCDEFGHIJKLMNP", "ABCDEFGH", "ABCDEFGI"};
+    for(const char* a : samples)
+      for(const char* b : samples) {
+        const std::string_view sa{a}, sb{b};
+        if(sa.size() > MaxSize || sb.size() > MaxSize) continue;
+        inplace_string<MaxSize> lhs(MaxSize, '~');
+        inplace_string<MaxSize> rhs(MaxSize, '#');
+        lhs = a;
+        rhs = b;
+        EXPECT_EQ(sa == sb, lhs == rhs) << a << " == " << b;
+        EXPECT_EQ(sa < sb, lhs < rhs) << a << " < " << b;
+        EXPECT_EQ(sa >= sb, lhs >= rhs) << a << " >= " << b;
+        if(sa == sb) {
+          EXPECT_EQ(std::hash<inplace_string<MaxSize>>{}(lhs), std::hash<inplace_string<MaxSize>>{}(rhs));
+        }
+      }
+  }
+}
+
+TEST(inPlaceString, AppendInt1)
+{
+  inplace_string<32> str{"x="};
+  str.append_int(0).append_int(-7).append_int(std::int64_t{1234567890123});
+  EXPECT_EQ(str, "x=0-71234567890123");
+  str.clear();
+  str.append_int(std::numeric_limits<std::int64_t>::min());
+  EXPECT_EQ(str, "-9223372036854775808");
+  str.clear();
+  str.append_int(std::numeric_limits<std::int8_t>::min()).append_int(std::int16_t{32767});
+  EXPECT_EQ(str, "-12832767");
+
+  inplace_string<4> small{"ab"};
+  EXPECT_THROW(small.append_int(std::int8_t{-100}), std::length_error);
+  EXPECT_EQ(small, "ab");
+}
+
+TEST(inPlaceString, AppendInt2)
+{
+  constexpr auto str = [] {
+    inplace_string<16> s;
+    s.append_int(-42).append_uint(9001u);
+    return s;
+  }();
+  static_assert(str == "-429001", "");
+  EXPECT_EQ(str, "-429001");
+}
+
+TEST(inPlaceString, AppendUint1)
+{
+  inplace_string<40> str;
+  for(std::uint64_t v = 1, i = 0; i < 20; v *= 10, ++i) {
+    str.clear();
+    str.append_uint(v - 1).append_uint(v);
+    EXPECT_EQ(to_string(str), std::to_string(v - 1) + std::to_string(v));
+  }
+  str.clear();
+  str.append_uint(std::numeric_limits<std::uint64_t>::max());
+  EXPECT_EQ(str, "18446744073709551615");
+  inplace_wstring<32> wstr;
+  wstr.append_uint(1234u);
+  EXPECT_EQ(wstr, L"1234");
+}
+
+TEST(inPlaceString, AppendFloat1)
+{
+  inplace_string<32> str;
+  str.append_float(0.1).append(" ").append_float(1.5f).append(" ").append_float(-2.0);
+  EXPECT_EQ(str, "0.1 1.5 -2");
+  str.clear();
+  str.append_float(1e300);
+  EXPECT_EQ(str, "1e+300");
+  str.clear();
+  str.append_float(0.30000000000000004);
+  EXPECT_EQ(str, "0.30000000000000004");
+  EXPECT_EQ(std::strtod(str.c_str(), nullptr), 0.30000000000000004);
+
+  inplace_string<24> full(20, 'x');
+  EXPECT_THROW(full.append_float(0.123456), std::length_error);
+  EXPECT_EQ(full.size(), 20);
+  EXPECT_EQ(std::strlen(full.c_str()), 20u);
+  full.append_float(12.5);
+  EXPECT_EQ(full, "xxxxxxxxxxxxxxxxxxxx12.5");
+
+  inplace_wstring<32> wstr;
+  wstr.append_float(-0.25);
+  EXPECT_EQ(wstr, L"-0.25");
+}
+
+TEST(inPlaceString, AppendFixed1)
+{
+  inplace_string<32> str;
+  str.append_fixed(101.256, 2);
+  EXPECT_EQ(str, "101.26");
+  str.clear();
+  str.append_fixed(-0.05, 3);
+  EXPECT_EQ(str, "-0.050");
+  str.clear();
+  str.append_fixed(42.7, 0);
+  EXPECT_EQ(str, "43");
+  str.clear();
+  str.append_fixed(0.000001, 18);
+  EXPECT_EQ(str, "0.000001000000000000");
+  str.clear();
+  str.append_fixed(-0.0001, 2);
+  EXPECT_EQ(str, "0.00");
+  EXPECT_THROW(str.append_fixed(1.0, 19), std::out_of_range);
+  EXPECT_THROW(str.append_fixed(1e19, 0), std::out_of_range);
+  EXPECT_THROW(str.append_fixed(std::nan(""), 2), std::out_of_range);
+}
+
+TEST(inPlaceString, ParseUint1)
+{
+  EXPECT_EQ(parse_uint(inplace_string<8>{"0"}).value, 0u);
+  EXPECT_EQ(parse_uint(inplace_string<8>{"12345678"}).value, 12345678u);
+  EXPECT_EQ(parse_uint(inplace_string<32>{"+000000000000123456789"}).value, 123456789u);
+  EXPECT_EQ(parse_uint(inplace_string<20>{"18446744073709551615"}).value, 18446744073709551615u);
+  EXPECT_EQ(parse_uint(inplace_string<20>{"18446744073709551616"}).status, parse_status::out_of_range);
+  EXPECT_EQ(parse_uint(inplace_string<32>{"123456789012345678901"}).status, parse_status::out_of_range);
+  EXPECT_EQ(parse_uint<std::uint8_t>(inplace_string<8>{"255"}).value, 255);
+  EXPECT_EQ(parse_uint<std::uint8_t>(inplace_string<8>{"256"}).status, parse_status::out_of_range);
+  EXPECT_EQ(parse_uint(inplace_string<8>{""}).status, parse_status::invalid);
+  EXPECT_EQ(parse_uint(inplace_string<8>{"+"}).status, parse_status::invalid);
+  EXPECT_EQ(parse_uint(inplace_string<8>{"-1"}).status, parse_status::invalid);
+  EXPECT_EQ(parse_uint(inplace_string<16>{"1234567x9"}).status, parse_status::invalid);
+  EXPECT_EQ(parse_uint(inplace_string<16>{"12 4"}).status, parse_status::invalid);
+  EXPECT_FALSE(parse_uint(inplace_string<16>{"12:4"}));
+  EXPECT_TRUE(parse_uint(inplace_string<16>{"1294"}));
+}
+
+TEST(inPlaceString, ParseUint2)
+{
+  // all lengths and positions against std::from_chars, including reads up to the end of the storage
+  const std::string digits = "98765432109876543210";
+  for(std::size_t pos = 0; pos < digits.size(); ++pos) {
+    for(std::size_t n = 1; pos + n <= digits.size(); ++n) {
+      const auto sub = digits.substr(pos, n);
+      std::uint64_t expected = 0;
+      const auto ec = std::from_chars(sub.data(), sub.data() + sub.size(), expected).ec;
+      const auto result = parse_uint(inplace_string<20>{sub.c_str()});
+      EXPECT_EQ(result.status, ec == std::errc{} ? parse_status::ok : parse_status::out_of_range) << sub;
+      EXPECT_EQ(result.value, ec == std::errc{} ? expected : 0) << sub;
+      EXPECT_EQ(parse_uint(inplace_string<3>(std::min<std::size_t>(n, 3), '7')).value,
+                std::stoull(std::string(std::min<std::size_t>(n, 3), '7')));
+    }
+  }
+}
+
+TEST(inPlaceString, ParseInt1)
+{
+  EXPECT_EQ(parse_int(inplace_string<8>{"-42"}).value, -42);
+  EXPECT_EQ(parse_int(inplace_string<8>{"+42"}).value, 42);
+  EXPECT_EQ(parse_int(inplace_string<8>{"-0"}).value, 0);
+  EXPECT_EQ(parse_int(inplace_string<20>{"-9223372036854775808"}).value, std::numeric_limits<std::int64_t>::min());
+  EXPECT_EQ(parse_int(inplace_string<20>{"9223372036854775807"}).value, std::numeric_limits<std::int64_t>::max());
+  EXPECT_EQ(parse_int(inplace_string<20>{"9223372036854775808"}).status, parse_status::out_of_range);
+  EXPECT_EQ(parse_int<std::int8_t>(inplace_string<8>{"-128"}).value, -128);
+  EXPECT_EQ(parse_int<std::int8_t>(inplace_string<8>{"128"}).status, parse_status::out_of_range);
+  EXPECT_EQ(parse_int(inplace_string<8>{"-"}).status, parse_status::invalid);
+  EXPECT_EQ(parse_int(inplace_string<8>{"--1"}).status, parse_status::invalid);
+  EXPECT_EQ(parse_int(inplace_string<8>{"1.0"}).status, parse_status::invalid);
+}
+
+TEST(inPlaceString, ParseDecimal1)
+{
+  EXPECT_EQ(parse_decimal(inplace_string<16>{"101.25"}, 4).value, 1012500);
+  EXPECT_EQ(parse_decimal(inplace_string<16>{"-101.25"}, 2).value, -10125);
+  EXPECT_EQ(parse_decimal(inplace_string<16>{"0.05"}, 3).value, 50);
+  EXPECT_EQ(parse_decimal(inplace_string<16>{".5"}, 1).value, 5);
+  EXPECT_EQ(parse_decimal(inplace_string<16>{"7."}, 2).value, 700);
+  EXPECT_EQ(parse_decimal(inplace_string<16>{"42"}, 0).value, 42);
+  EXPECT_EQ(parse_decimal(inplace_string<16>{"1.2500"}, 2).value, 125);
+  EXPECT_EQ(parse_decimal(inplace_string<16>{"1.2510"}, 2).status, parse_status::invalid);
+  EXPECT_EQ(parse_decimal(inplace_string<32>{"0.123456789012345678"}, 18).value, 123456789012345678);
+  EXPECT_EQ(parse_decimal(inplace_string<32>{"-9.223372036854775808"}, 18).value,
+            std::numeric_limits<std::int64_t>::min());
+  EXPECT_EQ(parse_decimal(inplace_string<32>{"9.223372036854775808"}, 18).status, parse_status::out_of_range);
+  EXPECT_EQ(parse_decimal(inplace_string<32>{"92233720368547758.08"}, 2).status, parse_status::out_of_range);
+  EXPECT_EQ(parse_decimal(inplace_string<16>{"."}, 2).status, parse_status::invalid);
+  EXPECT_EQ(parse_decimal(inplace_string<16>{"1.2.3"}, 2).status, parse_status::invalid);
+  EXPECT_EQ(parse_decimal(inplace_string<16>{"1e5"}, 2).status, parse_status::invalid);
+  EXPECT_THROW(parse_decimal(inplace_string<16>{"1"}, 19), std::out_of_range);
+}
+
+TEST(inPlaceString, WordSized1)
+{
+  static_assert(sizeof(inplace_string<7>) == 8, "");
+  static_assert(sizeof(inplace_string<15>) == 16, "");
+  check_word_sized_operations<7>();
+  check_word_sized_operations<15>();
+}
+
+TEST(inPlaceString, WordSized2)
+{
+  inplace_string<7> a{std::string_view{"a\0b", 3}};
+  inplace_string<7> b{std::string_view{"a\0c", 3}};
+  inplace_string<7> c{std::string_view{"a\0", 2}};
+  EXPECT_NE(a, b);
+  EXPECT_LT(a, b);
+  EXPECT_LT(c, a);
+  EXPECT_NE(c, inplace_string<7>{"a"});
+}
+
+TEST(inPlaceString, WordSized3)
+{
+  inplace_string<7> a(7, '~');
+  a.assign("ab", 2);
+  EXPECT_EQ(2u, a.size());
+  EXPECT_STREQ("ab", a.c_str());
+  EXPECT_EQ(a, inplace_string<7>{"ab"});
+  a.assign(a.data() + 1, 1);
+  EXPECT_STREQ("b", a.c_str());
+  for(char c = 'c'; c <= 'h'; ++c) a.push_back(c);
+  EXPECT_EQ(7u, a.size());
+  EXPECT_STREQ("bcdefgh", a.c_str());
+  EXPECT_THROW(a.push_back('i'), std::length_error);
+  EXPECT_STREQ("bcdefgh", a.c_str());
+
+  inplace_string<15> b;
+  for(char c = 'a'; c < 'a' + 15; ++c) {
+    b.push_back(c);
+    EXPECT_EQ(static_cast<std::size_t>(c - 'a' + 1), b.size());
+    EXPECT_EQ('\0', b.c_str()[b.size()]);
+  }
+  EXPECT_STREQ("abcdefghijklmno", b.c_str());
+  EXPECT_THROW(b.push_back('p'), std::length_error);
+  b.assign(b.data() + 10, 5);
+  EXPECT_EQ(b, inplace_string<15>{"klmno"});
+}
+
+TEST(inPlaceString, WordSizedOverflow)
+{
+  const char* text = "0123456789abcdefghijk";
+  EXPECT_DEATH(inplace_string<7>{}.assign(text, 21), "length_error|count <= MaxSize");
+  EXPECT_DEATH(inplace_string<15>{}.assign(text, 21), "length_error|count <= MaxSize");
+  EXPECT_DEATH(inplace_string<7>{text}, "length_error|count <= MaxSize");
+  EXPECT_DEATH(inplace_string<15>{text}, "length_error|count <= MaxSize");
+}
+
+TEST(inPlaceString, Hash1)
+{
+  EXPECT_EQ(std::hash<std::string_view>{}("abcdefgh"), std::hash<inplace_string<16>>{}(inplace_string<16>{"abcdefgh"}));
+  EXPECT_EQ(std::hash<inplace_string<7>>{}(inplace_string<7>{"abc"}), hash_value(inplace_string<7>{"abc"}));
+}
+
+TEST(inPlaceString, Output1)
+{
+  std::ostringstream os;
+  const inplace_string<16> str{"ab\0cd", 5};
+  os << str << '|' << std::setw(7) << std::left << inplace_string<8>{"xyz"} << '|';
+  EXPECT_EQ(os.str(), std::string("ab\0cd|xyz    |", 14));
+}
+
+TEST(inPlaceString, Input1)
+{
+  std::istringstream is{"  alpha beta\tgamma_is_long\n"};
+  inplace_string<8> str;
+  is >> str;
+  EXPECT_EQ(str, "alpha");
+  is >> str;
+  EXPECT_EQ(str, "beta");
+  is >> str;
+  EXPECT_EQ(str, "gamma_is");
+  is >> std::setw(3) >> str;
+  EXPECT_EQ(str, "_lo");
+  is >> str;
+  EXPECT_EQ(str, "ng");
+  EXPECT_TRUE(is.good());
+  is >> str;
+  EXPECT_TRUE(is.fail());
+  EXPECT_TRUE(is.eof());
+  EXPECT_EQ(str, "ng");
+}
+
+TEST(inPlaceString, Getline1)
+{
+  std::istringstream is{"first line\n\n12345678\n123456789\nlast"};
+  inplace_string<8> str;
+  EXPECT_FALSE(getline(is, str));
+  EXPECT_EQ(str, "first li");
+  is.clear();
+  EXPECT_TRUE(getline(is, str));
+  EXPECT_EQ(str, "ne");
+  EXPECT_TRUE(getline(is, str));
+  EXPECT_TRUE(str.empty());
+  EXPECT_TRUE(getline(is, str));
+  EXPECT_EQ(str, "12345678");
+  EXPECT_FALSE(getline(is, str));
+  EXPECT_EQ(str, "12345678");
+  is.clear();
+  EXPECT_TRUE(getline(is, str));
+  EXPECT_EQ(str, "9");
+  EXPECT_TRUE(getline(is, str, 'x'));
+  EXPECT_EQ(str, "last");
+  EXPECT_TRUE(is.eof());
+  EXPECT_FALSE(getline(is, str));
+  EXPECT_EQ(str, "last");
+}
+
+namespace {
+  // a stream buffer without a get area
+  class unbuffered_streambuf : public std::streambuf {
+  public:
+    explicit unbuffered_streambuf(std::string_view text) : text_{text} {}
+
+  private:
+    std::string_view text_;
+    int_type underflow() override { return text_.empty() ? traits_type::eof() : traits_type::to_int_type(text_[0]); }
+    int_type uflow() override
+    {
+      const auto c = underflow();
+      if(!text_.empty()) text_.remove_prefix(1);
+      return c;
+    }
+  };
+}
+
+TEST(inPlaceString, Input2)
+{
+  unbuffered_streambuf sb{" word other;line\nnext"};
+  std::istream is{&sb};
+  inplace_string<8> str;
+  is >> str;
+  EXPECT_EQ(str, "word");
+  EXPECT_TRUE(getline(is, str, ';'));
+  EXPECT_EQ(str, " other");
+  EXPECT_TRUE(getline(is, str));
+  EXPECT_EQ(str, "line");
+  EXPECT_TRUE(getline(is, str));
+  EXPECT_EQ(str, "next");
+  EXPECT_TRUE(is.eof());
+}
+
+TEST(inPlaceString, Input3)
+{
+  std::wistringstream is{L"wide text"};
+  inplace_wstring<8> str;
+  is >> str;
+  EXPECT_EQ(str, L"wide");
+  EXPECT_TRUE(getline(is, str));
+  EXPECT_EQ(str, L" text");
+}
+
 TEST(inPlaceString, AssignOther1)
 {
   inplace_string<16> str;
@@ -0,0 +1,90 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <mp/timestamp_formatter.h>
+#include <gtest/gtest.h>
+#include <ctime>
+#include <random>
+
+// explicit instantiation needed to make code coverage metrics work correctly
+template class mp::timestamp_formatter<std::chrono::microseconds>;
+
+using namespace mp;
+using namespace std::chrono;
+
+namespace {
+  system_clock::time_point from_epoch(std::int64_t s, microseconds us = microseconds{0})
+  {
+    return system_clock::time_point{duration_cast<system_clock::duration>(seconds{s} + us)};
+  }
+}
+
+TEST(timestampFormatter, Iso8601)
+{
+  timestamp_formatter<> fmt;
+  EXPECT_EQ(fmt(from_epoch(0)), "1970-01-01T00:00:00.000000Z");
+  EXPECT_EQ(fmt(from_epoch(1'700'000'000, microseconds{123'456})), "2023-11-14T22:13:20.123456Z");
+  EXPECT_EQ(fmt(from_epoch(1'700'000'000, microseconds{7})), "2023-11-14T22:13:20.000007Z");
+  EXPECT_EQ(fmt(from_epoch(1'700'000'039, microseconds{999'999})), "2023-11-14T22:13:59.999999Z");
+  EXPECT_EQ(fmt(from_epoch(1'700'000'040)), "2023-11-14T22:14:00.000000Z");
+  EXPECT_EQ(fmt(from_epoch(1'709'164'800)), "2024-02-29T00:00:00.000000Z");
+  EXPECT_EQ(fmt(from_epoch(0, microseconds{-1})), "1969-12-31T23:59:59.999999Z");
+  EXPECT_EQ(fmt.str(), "1969-12-31T23:59:59.999999Z");
+}
+
+TEST(timestampFormatter, Precision)
+{
+  const auto tp = system_clock::time_point{} + seconds{1'700'000'000} + nanoseconds{123'456'789};
+  EXPECT_EQ(timestamp_formatter<seconds>{}(tp), "2023-11-14T22:13:20Z");
+  EXPECT_EQ(timestamp_formatter<milliseconds>{}(tp), "2023-11-14T22:13:20.123Z");
+  EXPECT_EQ(timestamp_formatter<nanoseconds>{}(time_point<system_clock, nanoseconds>{tp}),
+            "2023-11-14T22:13:20.123456789Z");
+  EXPECT_EQ(timestamp_formatter<milliseconds>(timestamp_format::iso8601, hours{2})(tp),
+            "2023-11-15T00:13:20.123+02:00");
+  EXPECT_THROW(timestamp_formatter<nanoseconds>(timestamp_format::iso8601, hours{1}), std::invalid_argument);
+  EXPECT_THROW(timestamp_formatter<>(timestamp_format::iso8601, hours{24}), std::out_of_range);
+}
+
+TEST(timestampFormatter, CommonLog)
+{
+  timestamp_formatter<> fmt{timestamp_format::common_log, -hours{7}};
+  EXPECT_EQ(fmt(from_epoch(971'211'336, microseconds{500})), "[10/Oct/2000:13:55:36 -0700]");
+  EXPECT_EQ(fmt(from_epoch(1'700'000'000)), "[14/Nov/2023:15:13:20 -0700]");
+  timestamp_formatter<seconds> utc{timestamp_format::common_log, minutes{330}};
+  EXPECT_EQ(utc(from_epoch(0)), "[01/Jan/1970:05:30:00 +0530]");
+}
+
+TEST(timestampFormatter, Gmtime)
+{
+  // consecutive and random time points against gmtime()
+  timestamp_formatter<seconds> fmt;
+  std::mt19937_64 gen{42};
+  std::int64_t t = 1'600'000'000;
+  for(int i = 0; i < 10'000; ++i) {
+    t += i % 2 ? static_cast<std::int64_t>(gen() % 100'000) : static_cast<std::int64_t>(gen() % 3);
+    const std::time_t tt = static_cast<std::time_t>(i % 100 == 0 ? gen() % 4'000'000'000 : t);
+    char expected[32];
+    std::strftime(expected, sizeof(expected), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&tt));
+    ASSERT_EQ(fmt(system_clock::from_time_t(tt)), expected);
+  }
+}
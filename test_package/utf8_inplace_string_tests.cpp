@@ -0,0 +1,176 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <mp/utf8_inplace_string.h>
+#include <gtest/gtest.h>
+#include <random>
+#include <sstream>
+#include <string>
+
+// explicit instantiation needed to make code coverage metrics work correctly
+template class mp::basic_utf8_inplace_string<char, 16, std::char_traits<char>>;
+
+using namespace mp;
+
+namespace {
+
+  bool valid(const std::string& s) { return detail::is_valid_utf8(s.data(), s.size()); }
+
+}
+
+TEST(utf8Validation, Sequences)
+{
+  EXPECT_TRUE(valid(""));
+  EXPECT_TRUE(valid("plain ascii"));
+  EXPECT_TRUE(valid("\xc2\x80 \xdf\xbf \xe0\xa0\x80 \xed\x9f\xbf \xee\x80\x80 \xef\xbf\xbf"));
+  EXPECT_TRUE(valid("\xf0\x90\x80\x80 \xf4\x8f\xbf\xbf"));
+  EXPECT_FALSE(valid("\x80"));                  // lone continuation
+  EXPECT_FALSE(valid("\xc0\x80"));              // overlong 2-byte
+  EXPECT_FALSE(valid("\xc1\xbf"));              // overlong 2-byte
+  EXPECT_FALSE(valid("\xe0\x9f\xbf"));          // overlong 3-byte
+  EXPECT_FALSE(valid("\xed\xa0\x80"));          // surrogate
+  EXPECT_FALSE(valid("\xf0\x8f\xbf\xbf"));      // overlong 4-byte
+  EXPECT_FALSE(valid("\xf4\x90\x80\x80"));      // above U+10FFFF
+  EXPECT_FALSE(valid("\xf5\x80\x80\x80"));      // invalid lead
+  EXPECT_FALSE(valid("\xff"));                  // invalid byte
+  EXPECT_FALSE(valid("\xe2\x82"));              // truncated
+  EXPECT_FALSE(valid("\xe2\x82\xac\xac"));      // extra continuation
+  EXPECT_FALSE(valid("a\xc3"));                 // truncated at the end
+}
+
+TEST(utf8Validation, MatchesScalarAtEveryPosition)
+{
+  const std::string samples[] = {"\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80", "\x80",
+                                 "\xc3",     "\xe2\x82",     "\xf0\x9f\x98",     "\xed\xa0\x80",
+                                 "\xc0\xaf", "\xf4\x90\x80\x80", "\xfe"};
+  for(const auto& sample : samples) {
+    for(std::size_t size = 0; size <= 48; ++size) {
+      for(std::size_t pos = 0; pos + sample.size() <= size; ++pos) {
+        std::string text(size, 'a');
+        text.replace(pos, sample.size(), sample);
+        const auto expected =
+            detail::is_valid_utf8_scalar(reinterpret_cast<const unsigned char*>(text.data()), text.size());
+        ASSERT_EQ(valid(text), expected) << size << ' ' << pos;
+      }
+    }
+  }
+}
+
+TEST(utf8Validation, AllShortSequences)
+{
+  std::string third = {'\x00', '\x41', '\x7f', '\xc0', '\xc3', '\xe2', '\xf0', '\xff'};
+  for(int c = 0x80; c < 0xC0; ++c) third += static_cast<char>(c);
+  unsigned char buf[3];
+  for(unsigned a = 0; a < 256; ++a) {
+    for(unsigned b = 0; b < 256; ++b) {
+      for(const char c : third) {
+        buf[0] = static_cast<unsigned char>(a);
+        buf[1] = static_cast<unsigned char>(b);
+        buf[2] = static_cast<unsigned char>(c);
+        for(std::size_t n = 1; n <= 3; ++n)
+          ASSERT_EQ(detail::is_valid_utf8(buf, n), detail::is_valid_utf8_scalar(buf, n)) << a << ' ' << b << ' ' << n;
+      }
+    }
+  }
+}
+
+TEST(utf8Validation, RandomMatchesScalar)
+{
+  std::mt19937 gen(7);
+  const char* pieces[] = {"a", "z", "\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80", "\xed\x9f\xbf", "\xf4\x8f\xbf\xbf"};
+  for(int i = 0; i < 20000; ++i) {
+    std::string text;
+    while(text.size() < 64) text += pieces[gen() % std::size(pieces)];
+    if(i % 2) text[gen() % text.size()] = static_cast<char>(gen());
+    const auto expected =
+        detail::is_valid_utf8_scalar(reinterpret_cast<const unsigned char*>(text.data()), text.size());
+    ASSERT_EQ(valid(text), expected) << i;
+    if(i % 2 == 0) {
+      ASSERT_TRUE(expected);
+    }
+  }
+}
+
+TEST(utf8InplaceString, AssignAppend)
+{
+  utf8_inplace_string<16> str{"caf\xc3\xa9"};
+  EXPECT_EQ(str.size(), 5u);
+  str += " \xe2\x82\xac";
+  EXPECT_EQ(str, "caf\xc3\xa9 \xe2\x82\xac");
+  str += U'\U0001F600';
+  EXPECT_EQ(str, "caf\xc3\xa9 \xe2\x82\xac\xf0\x9f\x98\x80");
+  EXPECT_THROW(str.append("\xc3"), std::invalid_argument);
+  EXPECT_THROW(str.append("1234"), std::length_error);
+  EXPECT_THROW(str.append(char32_t{0xD800}), std::invalid_argument);
+  EXPECT_THROW(str.append(char32_t{0x110000}), std::invalid_argument);
+  EXPECT_EQ(str.size(), 13u);
+  EXPECT_THROW(str.assign("\xff"), std::invalid_argument);
+  EXPECT_EQ(str.size(), 13u);
+  EXPECT_EQ(str.try_assign("\xe2\x82"), parse_status::invalid);
+  EXPECT_EQ(str.try_append("12345"), parse_status::out_of_range);
+  EXPECT_EQ(str.try_assign("ok"), parse_status::ok);
+  EXPECT_EQ(str, "ok");
+}
+
+TEST(utf8InplaceString, AppendTruncated)
+{
+  utf8_inplace_string<8> str{"ab"};
+  // 6 bytes left: the euro sign fits twice, the third one would be split
+  EXPECT_EQ(str.append_truncated("\xe2\x82\xac\xe2\x82\xac\xe2\x82\xac"), 6u);
+  EXPECT_EQ(str, "ab\xe2\x82\xac\xe2\x82\xac");
+  str.assign("abcde");
+  EXPECT_EQ(str.append_truncated("\xf0\x9f\x98\x80"), 0u);
+  EXPECT_EQ(str.append_truncated("x\xf0\x9f\x98\x80"), 1u);
+  EXPECT_EQ(str, "abcdex");
+  EXPECT_EQ(str.append_truncated("\xc3\xa9z"), 2u);
+  EXPECT_EQ(str, "abcdex\xc3\xa9");
+  str.clear();
+  EXPECT_THROW(str.append_truncated("\xc3(abc"), std::invalid_argument);
+}
+
+TEST(utf8InplaceString, PopBack)
+{
+  utf8_inplace_string<16> str{"a\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80"};
+  str.pop_back();
+  EXPECT_EQ(str, "a\xc3\xa9\xe2\x82\xac");
+  str.pop_back();
+  EXPECT_EQ(str, "a\xc3\xa9");
+  str.pop_back();
+  EXPECT_EQ(str, "a");
+  str.pop_back();
+  EXPECT_TRUE(str.empty());
+  str.pop_back();
+  EXPECT_TRUE(str.empty());
+}
+
+TEST(utf8InplaceString, Observers)
+{
+  const utf8_inplace_string<16> str{"\xc3\xa9t\xc3\xa9"};
+  EXPECT_EQ(std::string_view{str}, "\xc3\xa9t\xc3\xa9");
+  EXPECT_EQ(str.str(), inplace_string<16>{"\xc3\xa9t\xc3\xa9"});
+  EXPECT_EQ(std::hash<utf8_inplace_string<16>>{}(str), std::hash<inplace_string<16>>{}(str.str()));
+  EXPECT_TRUE(utf8_inplace_string<16>{"a"} < utf8_inplace_string<16>{"b"});
+  std::ostringstream os;
+  os << str;
+  EXPECT_EQ(os.str(), "\xc3\xa9t\xc3\xa9");
+}
@@ -0,0 +1,253 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Recommends mp::inplace_string<MaxSize> capacities from sample data.
+//
+// Reads newline-delimited values or CSV/TSV columns from files (or stdin), reports the distribution of
+// value lengths per field and the smallest MaxSize covering the requested percentiles of values together
+// with the resulting sizeof(inplace_string<MaxSize>) and the memory footprint for a number of rows.
+
+#include <mp/inplace_string.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+  static_assert(sizeof(mp::inplace_string<7>) == 8 && sizeof(mp::inplace_string<255>) == 256,
+                "the footprint formula below assumes MaxSize + 1 bytes per inplace_string<MaxSize>");
+  constexpr std::size_t max_inplace_size = std::numeric_limits<std::uint8_t>::max();
+
+  enum class input_format { lines, csv, tsv };
+
+  struct options {
+    input_format format = input_format::lines;
+    char delimiter = ',';
+    bool header = false;
+    std::vector<double> coverage = {50.0, 90.0, 99.0, 99.9, 100.0};
+    std::size_t rows = 1'000'000;
+    std::vector<std::string> files;
+  };
+
+  struct field {
+    std::string name;
+    std::vector<std::size_t> lengths;
+  };
+
+  void usage(std::ostream& os)
+  {
+    os << "Usage: capacity_advisor [options] [file...]\n"
+          "  --lines              one value per line (default)\n"
+          "  --csv                comma-separated columns\n"
+          "  --tsv                tab-separated columns\n"
+          "  --delimiter <c>      custom column delimiter (implies --csv)\n"
+          "  --header             first row of each file contains column names (CSV/TSV only)\n"
+          "  --coverage <p,...>   coverage percentiles (default: 50,90,99,99.9,100)\n"
+          "  --rows <n>           row count for the footprint estimate (default: 1000000)\n"
+          "Reads standard input when no file is given.\n";
+  }
+
+  std::vector<double> parse_coverage(const std::string& text)
+  {
+    std::vector<double> result;
+    std::istringstream is{text};
+    for(std::string item; std::getline(is, item, ',');) {
+      const double p = std::stod(item);
+      if(p <= 0.0 || p > 100.0) throw std::invalid_argument("coverage must be in (0, 100]");
+      result.push_back(p);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+  options parse_options(int argc, char* argv[])
+  {
+    options opt;
+    for(int i = 1; i < argc; ++i) {
+      const std::string arg = argv[i];
+      auto value = [&] {
+        if(i + 1 >= argc) throw std::invalid_argument("missing value for " + arg);
+        return std::string{argv[++i]};
+      };
+      if(arg == "--lines")
+        opt.format = input_format::lines;
+      else if(arg == "--csv")
+        opt.format = input_format::csv;
+      else if(arg == "--tsv") {
+        opt.format = input_format::tsv;
+        opt.delimiter = '\t';
+      }
+      else if(arg == "--delimiter") {
+        const auto d = value();
+        if(d.size() != 1) throw std::invalid_argument("delimiter must be a single character");
+        opt.format = input_format::csv;
+        opt.delimiter = d[0];
+      }
+      else if(arg == "--header")
+        opt.header = true;
+      else if(arg == "--coverage")
+        opt.coverage = parse_coverage(value());
+      else if(arg == "--rows")
+        opt.rows = std::stoull(value());
+      else if(arg == "--help" || arg == "-h") {
+        usage(std::cout);
+        std::exit(EXIT_SUCCESS);
+      }
+      else if(arg.size() > 1 && arg[0] == '-')
+        throw std::invalid_argument("unknown option " + arg);
+      else
+        opt.files.push_back(arg);
+    }
+    if(opt.header && opt.format == input_format::lines)
+      throw std::invalid_argument("--header requires --csv, --tsv or --delimiter");
+    return opt;
+  }
+
+  // splits one CSV record honoring double-quoted fields (quoted line breaks are not supported)
+  std::vector<std::string> split_record(const std::string& line, char delimiter)
+  {
+    std::vector<std::string> result(1);
+    bool quoted = false;
+    for(std::size_t i = 0; i < line.size(); ++i) {
+      const char c = line[i];
+      if(quoted) {
+        if(c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+          result.back() += '"';
+          ++i;
+        }
+        else if(c == '"')
+          quoted = false;
+        else
+          result.back() += c;
+      }
+      else if(c == '"')
+        quoted = true;
+      else if(c == delimiter)
+        result.emplace_back();
+      else
+        result.back() += c;
+    }
+    return result;
+  }
+
+  void read(std::istream& is, const options& opt, std::vector<field>& fields)
+  {
+    bool header_pending = opt.header;
+    for(std::string line; std::getline(is, line);) {
+      if(!line.empty() && line.back() == '\r') line.pop_back();
+      auto values = opt.format == input_format::lines ? std::vector<std::string>{line} : split_record(line, opt.delimiter);
+      if(fields.size() < values.size()) {
+        for(auto i = fields.size(); i < values.size(); ++i) fields.push_back({"column " + std::to_string(i + 1), {}});
+      }
+      if(header_pending) {
+        for(std::size_t i = 0; i < values.size(); ++i) fields[i].name = values[i];
+        header_pending = false;
+        continue;
+      }
+      for(std::size_t i = 0; i < values.size(); ++i) fields[i].lengths.push_back(values[i].size());
+    }
+  }
+
+  // number of decimals (up to 3) that prints a requested percentile without rounding it
+  int decimals(double p)
+  {
+    int d = 0;
+    for(double scaled = p; d < 3 && std::fabs(scaled - std::round(scaled)) > 1e-6; scaled *= 10) ++d;
+    return d;
+  }
+
+  std::string human_bytes(double bytes)
+  {
+    const char* units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+    std::size_t unit = 0;
+    while(bytes >= 1024.0 && unit + 1 < std::size(units)) {
+      bytes /= 1024.0;
+      ++unit;
+    }
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << bytes << ' ' << units[unit];
+    return os.str();
+  }
+
+  void report(std::ostream& os, field& f, const options& opt)
+  {
+    auto& lengths = f.lengths;
+    os << f.name << ":";
+    if(lengths.empty()) {
+      os << " no values\n\n";
+      return;
+    }
+    std::sort(lengths.begin(), lengths.end());
+    double sum = 0;
+    for(auto l : lengths) sum += static_cast<double>(l);
+    os << " values=" << lengths.size() << " min=" << lengths.front() << " max=" << lengths.back()
+       << " mean=" << std::fixed << std::setprecision(1) << sum / static_cast<double>(lengths.size()) << '\n';
+
+    os << "  " << std::setw(9) << "coverage" << std::setw(9) << "MaxSize" << std::setw(9) << "sizeof" << std::setw(10)
+       << "overflow" << std::setw(14) << "footprint" << '\n';
+    for(double p : opt.coverage) {
+      // the smallest length that is not shorter than p% of the values
+      const auto count = static_cast<std::size_t>(std::ceil(p / 100.0 * static_cast<double>(lengths.size())));
+      const std::size_t max_size = lengths[std::max<std::size_t>(count, 1) - 1];
+      const auto overflow = static_cast<std::size_t>(lengths.end() - std::upper_bound(lengths.begin(), lengths.end(), max_size));
+      const std::size_t object_size = max_size + 1;
+      os << "  " << std::setw(8) << std::setprecision(decimals(p)) << p << '%'
+         << std::setw(9) << max_size << std::setw(9) << object_size << std::setw(10) << overflow << std::setw(14)
+         << human_bytes(static_cast<double>(object_size) * static_cast<double>(opt.rows));
+      if(max_size > max_inplace_size) os << "  (above the inplace_string<char> limit of " << max_inplace_size << ")";
+      os << '\n';
+    }
+    os << '\n';
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  try {
+    const auto opt = parse_options(argc, argv);
+    std::vector<field> fields;
+    if(opt.files.empty())
+      read(std::cin, opt, fields);
+    else
+      for(const auto& name : opt.files) {
+        std::ifstream file{name};
+        if(!file) throw std::runtime_error("cannot open '" + name + "'");
+        read(file, opt, fields);
+      }
+
+    std::cout << "Footprint for " << opt.rows << " rows\n\n";
+    for(auto& f : fields) report(std::cout, f, opt);
+    return EXIT_SUCCESS;
+  }
+  catch(const std::exception& ex) {
+    std::cerr << "capacity_advisor: " << ex.what() << "\n";
+    usage(std::cerr);
+    return EXIT_FAILURE;
+  }
+}